@@ -0,0 +1,114 @@
+// DEF 讀檔 / 寫檔吞吐量 (MB/s)。
+//   bench_def_reader <DEF> [--repeat R] [--scale K] [--threads T]
+// --threads T：大的區段切塊後交給 T 個執行緒解析。
+// --scale K 會先把輸入複製 K 份 (instance / net 改名) 寫成合成的大 DEF 再量測。
+#include <bits/stdc++.h>
+#include "../core/design.hpp"
+#include "../core/thread_pool.hpp"
+#include "../io/def_reader.hpp"
+#include "../io/def_writer.hpp"
+
+using namespace std;
+
+static void write_scaled_def(const core::Design& d, int k, const string& path) {
+  ofstream os(path, ios::trunc);
+  if (!os.is_open()) throw runtime_error("Cannot open " + path);
+
+  os << "VERSION 5.8 ;\nDESIGN scaled ;\n";
+  os << "UNITS DISTANCE MICRONS " << d.units.def_dbu_per_um << " ;\n\n";
+  os << "DIEAREA ( " << d.die_llx << ' ' << d.die_lly << " ) ( "
+     << d.die_urx << ' ' << d.die_ury << " ) ;\n\n";
+  for (const auto& r : d.rows) {
+    os << "ROW " << d.str(r.name) << ' ' << d.str(r.site) << ' ' << r.x0 << ' ' << r.y0 << ' '
+       << core::orient_name(r.orient) << " DO " << r.nx << " BY " << r.ny
+       << " STEP " << r.step_x << ' ' << r.step_y << "\n;\n";
+  }
+
+  os << "\nCOMPONENTS " << d.instances.size() * k << " ;\n";
+  for (int c = 0; c < k; ++c) {
+    for (const auto& inst : d.instances) {
+      os << "  - " << d.str(inst.name) << "_c" << c << ' ' << d.str(inst.macro) << "\n    + "
+         << (inst.fixed ? "FIXED" : "PLACED") << " ( " << inst.x << ' ' << inst.y
+         << " ) " << core::orient_name(inst.orient) << " ;\n";
+    }
+  }
+  os << "END COMPONENTS\n\n";
+
+  os << "NETS " << d.nets.size() * k << " ;\n";
+  for (int c = 0; c < k; ++c) {
+    for (const auto& net : d.nets) {
+      os << "- " << d.str(net.name) << "_c" << c << '\n';
+      for (core::NameId inst : net.insts) os << "( " << d.str(inst) << "_c" << c << " A ) ";
+      os << "\n;\n";
+    }
+  }
+  os << "END NETS\n\nEND DESIGN\n";
+}
+
+static void bench(const string& path, int repeat, core::ThreadPool* pool) {
+  ifstream f(path, ios::binary | ios::ate);
+  double mb = f.tellg() / (1024.0 * 1024.0);
+
+  double best = numeric_limits<double>::max();
+  size_t insts = 0, nets = 0;
+  for (int r = 0; r < repeat; ++r) {
+    core::Design d;
+    io::DefReader reader;
+    reader.pool = pool;
+    auto t0 = chrono::steady_clock::now();
+    reader.read(path, d);
+    auto t1 = chrono::steady_clock::now();
+    best = min(best, chrono::duration<double>(t1 - t0).count());
+    insts = d.instances.size();
+    nets = d.nets.size();
+  }
+
+  cout << fixed << setprecision(2)
+       << path << ": " << mb << " MB, " << insts << " components, " << nets << " nets, "
+       << best * 1e3 << " ms, " << mb / best << " MB/s\n";
+
+  // 寫檔：reader 保留 mmap，writer 拼接未修改的部分，COMPONENTS 只改移動過的擺放子句
+  core::Design d;
+  io::DefReader reader;
+  reader.read(path, d);
+  const char* tmp = getenv("TMPDIR");
+  string out = string(tmp ? tmp : "/tmp") + "/bench_write.def";
+  best = numeric_limits<double>::max();
+  for (int r = 0; r < repeat; ++r) {
+    auto t0 = chrono::steady_clock::now();
+    io::DefWriter().write(reader, d, out);
+    auto t1 = chrono::steady_clock::now();
+    best = min(best, chrono::duration<double>(t1 - t0).count());
+  }
+  remove(out.c_str());
+  cout << "  write: " << best * 1e3 << " ms, " << mb / best << " MB/s\n";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <DEF> [--repeat R] [--scale K] [--threads T]\n";
+    return 1;
+  }
+
+  string def = argv[1];
+  int repeat = 5, scale = 0, threads = 1;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    string opt = argv[i];
+    if (opt == "--repeat") repeat = stoi(argv[i + 1]);
+    else if (opt == "--scale") scale = stoi(argv[i + 1]);
+    else if (opt == "--threads") threads = stoi(argv[i + 1]);
+  }
+  core::ThreadPool pool(threads);
+
+  bench(def, repeat, &pool);
+
+  if (scale > 0) {
+    core::Design d;
+    io::DefReader().read(def, d);
+    const char* tmp = getenv("TMPDIR");
+    string out = string(tmp ? tmp : "/tmp") + "/bench_scaled_x" + to_string(scale) + ".def";
+    write_scaled_def(d, scale, out);
+    bench(out, repeat, &pool);
+    remove(out.c_str());
+  }
+}
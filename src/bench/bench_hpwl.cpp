@@ -0,0 +1,100 @@
+// HPWL kernel micro-benchmark：以名稱查表的 hpwl_counts(Design)、
+// CSR scalar 版 hpwl_counts(Netlist)、以及各 ISA 的向量化 kernel。
+//   bench_hpwl <LEF> <DEF> [--repeat R] [--scale K]
+// --scale K 把 netlist 在記憶體中複製 K 份 (超過 cache 才看得出頻寬上限)。
+#include <bits/stdc++.h>
+#include "../core/design.hpp"
+#include "../core/hpwl.hpp"
+#include "../core/hpwl_simd.hpp"
+#include "../core/hpwl_parallel.hpp"
+#include "../core/netlist.hpp"
+#include "../io/def_reader.hpp"
+#include "../io/lef_reader.hpp"
+
+using namespace std;
+
+static core::Netlist tile(const core::Netlist& nl, int k) {
+  core::Netlist t;
+  t.num_insts = nl.num_insts * k;
+  t.num_pins = 0;
+  t.num_nets = nl.num_nets * k;
+  t.net_start.push_back(0);
+  for (int c = 0; c < k; ++c) {
+    int off = c * nl.numNodes();
+    for (int i = 0; i < nl.numNodes(); ++i) {
+      t.x.push_back(nl.x[i]);
+      t.y.push_back(nl.y[i]);
+    }
+    for (int n = 0; n < nl.num_nets; ++n) {
+      for (int p = nl.netBegin(n); p < nl.netEnd(n); ++p) t.net_pins.push_back(nl.net_pins[p] + off);
+      t.net_start.push_back((int)t.net_pins.size());
+    }
+  }
+  t.num_insts = (int)t.x.size();
+  return t;
+}
+
+template <class F>
+static void run(const string& label, int repeat, size_t bytes, long long expect, F f) {
+  double best = numeric_limits<double>::max();
+  long long got = 0;
+  for (int r = 0; r < repeat; ++r) {
+    auto t0 = chrono::steady_clock::now();
+    got = f();
+    best = min(best, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+  }
+  cout << fixed << setprecision(3) << "  " << left << setw(22) << label << right
+       << setw(10) << best * 1e3 << " ms  " << setw(9) << bytes / best / 1e9 << " GB/s"
+       << (got == expect ? "" : "  MISMATCH") << '\n';
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    cerr << "Usage: " << argv[0] << " <LEF> <DEF> [--repeat R] [--scale K]\n";
+    return 1;
+  }
+  int repeat = 20, scale = 1;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    string opt = argv[i];
+    if (opt == "--repeat") repeat = stoi(argv[i + 1]);
+    else if (opt == "--scale") scale = stoi(argv[i + 1]);
+  }
+
+  core::Design d;
+  io::LefReader().read(argv[1], d);
+  io::DefReader().read(argv[2], d);
+  d.buildInstanceNetLists();
+  core::Netlist base;
+  base.build(d);
+
+  const core::Netlist nl = scale > 1 ? tile(base, scale) : base;
+  const size_t bytes = (nl.net_start.size() + nl.net_pins.size() * 3) * sizeof(int);
+  const long long expect = core::hpwl_counts(nl);
+
+  cout << nl.num_nets << " nets, " << nl.net_pins.size() << " pins, hpwl " << expect << '\n';
+  if (scale == 1) {
+    run("hpwl_counts(Design)", repeat, bytes, expect, [&] { return core::hpwl_counts(d); });
+  }
+  run("hpwl_counts(Netlist)", repeat, bytes, expect, [&] { return core::hpwl_counts(nl); });
+  for (auto isa : {core::HpwlIsa::Scalar, core::HpwlIsa::Avx2, core::HpwlIsa::Avx512}) {
+    if (!core::hpwl_isa_supported(isa)) continue;
+    run(string("kernel ") + core::hpwl_isa_name(isa), repeat, bytes, expect, [&] {
+      return core::hpwl_kernel(isa, nl.net_start.data(), nl.net_pins.data(), nl.num_nets,
+                               nl.x.data(), nl.y.data());
+    });
+  }
+
+  core::ThreadPool pool;
+  run("parallel x" + to_string(pool.size()), repeat, bytes, expect,
+      [&] { return core::hpwl_counts_parallel(nl, pool); });
+  run("report (per-net)", repeat, bytes, expect,
+      [&] { return core::hpwl_report(nl, pool).total; });
+
+  core::HpwlReport r = core::hpwl_report(nl, pool);
+  for (int n = 0; n < nl.num_nets; ++n) {
+    if (r.per_net[n] != core::net_hpwl(nl, n)) {
+      cout << "  per-net MISMATCH at net " << n << '\n';
+      break;
+    }
+  }
+}
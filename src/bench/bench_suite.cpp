@@ -0,0 +1,175 @@
+// 整體流程的計時：LefReader / DefReader / Netlist / hpwl_counts /
+// 各種大小的 solveRegion / DefWriter，結果另存成 JSON 方便比較不同版本與機器。
+//   bench_suite <LEF> <DEF> [--repeat R] [--regions N] [--json <file>]
+// 每一項取 R 次中最快的一次。solveRegion 以 k 個同寬度、在同一 row 上相鄰的
+// 可動單元為一個區域 (k = 8 ~ 128，沒有夠長的 row 時略過)，每種大小解 N 個區域，
+// 回報平均每個區域的時間。每次重複前都還原成原始座標，各次解的是同一組問題。
+// --json - 代表輸出到 stdout (表格改輸出到 stderr)。
+// 另外回報讀完 LEF / DEF 後 Design 的字串池大小與行程的峰值 RSS。
+#include <bits/stdc++.h>
+#include <sys/resource.h>
+#include "../core/design.hpp"
+#include "../core/hpwl.hpp"
+#include "../core/netlist.hpp"
+#include "../io/def_reader.hpp"
+#include "../io/def_writer.hpp"
+#include "../io/lef_reader.hpp"
+#include "../placer/detailed_placer.hpp"
+
+using namespace std;
+
+struct Result {
+  string name;
+  double ms = 0;        // 最快一次的時間
+  long long items = 0;  // 處理的數量 (單元 / net / 區域)
+  string unit;
+};
+
+template <class F>
+static double best_of(int repeat, F f) {
+  double best = numeric_limits<double>::max();
+  for (int r = 0; r < repeat; ++r) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    best = min(best, chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+  }
+  return best * 1e3;
+}
+
+static string json_escape(const string& s) {
+  string out;
+  for (char c : s) {
+    if (c == '"' || c == '\\') out += '\\';
+    out += c;
+  }
+  return out;
+}
+
+// 各 row 上相鄰的同寬度可動單元，每 k 個切成一個區域；區域不跨 row，
+// 一段不足 k 個的剩餘單元捨棄
+static vector<vector<int>> make_regions(const core::Netlist& nl, int k, int limit) {
+  vector<int> order;
+  for (int i = 0; i < nl.num_insts; ++i) {
+    if (!nl.fixed[i] && nl.width[i] > 0) order.push_back(i);
+  }
+  sort(order.begin(), order.end(), [&](int a, int b) {
+    if (nl.width[a] != nl.width[b]) return nl.width[a] < nl.width[b];
+    if (nl.y[a] != nl.y[b]) return nl.y[a] < nl.y[b];
+    return nl.x[a] < nl.x[b];
+  });
+  vector<vector<int>> all;
+  for (size_t b = 0; b < order.size(); ) {
+    size_t e = b + 1;
+    while (e < order.size() && nl.width[order[e]] == nl.width[order[b]] && nl.y[order[e]] == nl.y[order[b]]) ++e;
+    for (; b + k <= e; b += k) all.emplace_back(order.begin() + b, order.begin() + b + k);
+    b = e;
+  }
+  // 從所有候選中等距取樣，分散到各種寬度與整個晶片
+  vector<vector<int>> regions;
+  const size_t n = min(all.size(), (size_t)limit);
+  for (size_t i = 0; i < n; ++i) regions.push_back(move(all[i * all.size() / n]));
+  return regions;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    cerr << "Usage: " << argv[0] << " <LEF> <DEF> [--repeat R] [--regions N] [--json <file>]\n";
+    return 1;
+  }
+  const string lef_path = argv[1], def_path = argv[2];
+  int repeat = 3, num_regions = 64;
+  string json;
+  for (int i = 3; i + 1 < argc; i += 2) {
+    string opt = argv[i];
+    if (opt == "--repeat") repeat = max(1, stoi(argv[i + 1]));
+    else if (opt == "--regions") num_regions = max(1, stoi(argv[i + 1]));
+    else if (opt == "--json") json = argv[i + 1];
+  }
+  ostream& log = json == "-" ? cerr : cout;
+
+  vector<Result> results;
+  auto add = [&](const string& name, double ms, long long items, const string& unit) {
+    results.push_back({name, ms, items, unit});
+    log << fixed << setprecision(3) << "  " << left << setw(20) << name << right << setw(12) << ms
+        << " ms  " << setw(14) << setprecision(0) << (ms > 0 ? items / (ms / 1e3) : 0.0) << ' ' << unit << "/s\n";
+  };
+
+  core::Design d;
+  io::DefReader def;
+  io::LefReader().read(lef_path, d);
+  def.read(def_path, d);
+  d.buildInstanceNetLists();
+  const long long cells = (long long)d.instances.size();
+  const size_t name_bytes = d.names.bytes();
+
+  // 讀檔 (每次都是新的 Design，LEF 不使用快取)
+  add("lef_read", best_of(repeat, [&] { core::Design t; io::LefReader().read(lef_path, t); }), (long long)d.macros.size(), "macros");
+  add("def_read", best_of(repeat, [&] { core::Design t; io::DefReader().read(def_path, t); }), cells, "cells");
+
+  core::Netlist nl;
+  add("netlist_build", best_of(repeat, [&] { core::Netlist t; t.build(d); }), cells, "cells");
+  nl.build(d);
+
+  long long hpwl = 0;
+  add("hpwl_counts", best_of(max(repeat, 5), [&] { hpwl = core::hpwl_counts(nl); }), nl.num_nets, "nets");
+
+  // 區域指派：在 netlist 的複本上做，solveRegion 會改座標。
+  // 每次重複先把所有區域的單元還原成 nl 的座標 (只動 k * N 個單元，相對求解可忽略)
+  for (int k : {8, 16, 32, 64, 128}) {
+    vector<vector<int>> regions = make_regions(nl, k, num_regions);
+    if (regions.empty()) continue;
+    core::Netlist work = nl;
+    DetailedPlacer dp(d, work);
+    vector<DetailedPlacer::Pos> sites;
+    double ms = best_of(repeat, [&] {
+      for (const auto& region : regions) {
+        for (int c : region) {
+          work.x[c] = nl.x[c];
+          work.y[c] = nl.y[c];
+        }
+      }
+      for (const auto& region : regions) {
+        sites.clear();
+        for (int c : region) sites.push_back({work.x[c], work.y[c]});
+        dp.solveRegion(region, sites);
+      }
+    });
+    add("solve_region_k" + to_string(k), ms / regions.size(), 1, "regions");
+  }
+
+  const char* tmp = getenv("TMPDIR");
+  const string out = string(tmp ? tmp : "/tmp") + "/bench_suite_out.def";
+  nl.writeBack(d);
+  add("def_write", best_of(repeat, [&] { io::DefWriter().write(def, d, out); }), cells, "cells");
+  remove(out.c_str());
+
+  rusage ru{};
+  getrusage(RUSAGE_SELF, &ru);
+  const long peak_rss_kb = ru.ru_maxrss;
+  log << "  names " << d.names.size() << " (" << name_bytes / 1024 << " KB), peak rss " << peak_rss_kb << " KB\n";
+
+  if (json.empty()) return 0;
+  ofstream file;
+  if (json != "-") {
+    file.open(json, ios::trunc);
+    if (!file.is_open()) {
+      cerr << "Cannot open " << json << '\n';
+      return 1;
+    }
+  }
+  ostream& os = json == "-" ? cout : file;
+  os << "{\n  \"lef\": \"" << json_escape(lef_path) << "\",\n  \"def\": \"" << json_escape(def_path)
+     << "\",\n  \"cells\": " << d.instances.size() << ",\n  \"nets\": " << nl.num_nets
+     << ",\n  \"pins\": " << nl.net_pins.size() << ",\n  \"hpwl\": " << hpwl
+     << ",\n  \"names\": " << d.names.size() << ",\n  \"name_bytes\": " << name_bytes
+     << ",\n  \"peak_rss_kb\": " << peak_rss_kb
+     << ",\n  \"repeat\": " << repeat << ",\n  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    os << "    {\"name\": \"" << r.name << "\", \"ms\": " << fixed << setprecision(4) << r.ms
+       << ", \"items\": " << r.items << ", \"unit\": \"" << r.unit << "\"}"
+       << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  os << "  ]\n}\n";
+  return 0;
+}
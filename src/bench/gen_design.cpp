@@ -0,0 +1,312 @@
+// 合成 LEF / DEF 產生器，產生可調規模的測試設計 (最多數百萬個單元)。
+//   gen_design <輸出前綴> [options]
+// 輸出 <前綴>.lef 與 <前綴>.def。初始擺放合法 (對齊 site、不重疊)，
+// net 依「理想位置」在鄰近的單元之間連接，之後再把同寬度單元在局部範圍內隨機交換，
+// 所以 detailed placement 有改善空間。相同參數與 seed 產生相同檔案。
+//
+//   --cells N          單元數 (預設 100000)
+//   --util U           row 使用率 0~1 (預設 0.7)
+//   --rows R           row 數，預設依使用率取接近正方形的 die
+//   --widths w:p,...   單元寬度 (site 數) 與比例 (預設 2:30,3:25,4:20,6:15,10:10)
+//   --nets-per-cell F  net 數 / 單元數 (預設 1.0)
+//   --degree D         一般 net 的平均 pin 數 (預設 3.5，最少 2)
+//   --fanout P         高扇出 net 的比例 (預設 0.002)
+//   --fanout-max M     高扇出 net 最多幾個 pin (預設 500，最少 32)
+//   --fixed P          FIXED 單元的比例 (預設 0)
+//   --io N             die 邊界上的 IO pin 數 (預設 0)
+//   --perturb S        打亂的範圍 (同 row 內的單元數，預設 12)
+//   --seed S
+#include <bits/stdc++.h>
+
+using namespace std;
+
+static constexpr int kDbu = 2000;        // DBU / micron
+static constexpr int kSiteW = 200, kSiteH = 2400;
+
+struct Options {
+  long long cells = 100000;
+  double util = 0.7;
+  int rows = 0;
+  vector<pair<int, double>> widths = {{2, 30}, {3, 25}, {4, 20}, {6, 15}, {10, 10}};
+  double nets_per_cell = 1.0;
+  double degree = 3.5;
+  double fanout = 0.002;
+  int fanout_max = 500;
+  double fixed = 0;
+  int io = 0;
+  int perturb = 12;
+  uint64_t seed = 1;
+};
+
+struct Cell {
+  int w = 0;      // site 數
+  int row = 0;
+  int col = 0;    // site 索引
+  bool fixed = false;
+};
+
+static vector<pair<int, double>> parse_widths(const string& s) {
+  vector<pair<int, double>> out;
+  stringstream ss(s);
+  string item;
+  while (getline(ss, item, ',')) {
+    size_t c = item.find(':');
+    int w = stoi(item.substr(0, c));
+    double p = c == string::npos ? 1.0 : stod(item.substr(c + 1));
+    if (w > 0 && p > 0) out.push_back({w, p});
+  }
+  if (out.empty()) throw runtime_error("bad --widths: " + s);
+  return out;
+}
+
+// 大量輸出用的緩衝區，滿了就 fwrite
+class Out {
+public:
+  explicit Out(const string& path) : f_(fopen(path.c_str(), "wb")) {
+    if (!f_) throw runtime_error("Cannot open " + path);
+    buf_.reserve(1 << 20);
+  }
+  ~Out() { flush(); fclose(f_); }
+  Out& operator<<(string_view s) { buf_.append(s); check(); return *this; }
+  Out& operator<<(char c) { buf_.push_back(c); check(); return *this; }
+  Out& operator<<(long long v) {
+    char tmp[24];
+    auto r = to_chars(tmp, tmp + sizeof(tmp), v);
+    buf_.append(tmp, r.ptr);
+    check();
+    return *this;
+  }
+  Out& operator<<(int v) { return *this << (long long)v; }
+
+private:
+  FILE* f_;
+  string buf_;
+  void check() { if (buf_.size() >= (1 << 20)) flush(); }
+  void flush() { fwrite(buf_.data(), 1, buf_.size(), f_); buf_.clear(); }
+};
+
+// FIXED 單元用 CLASS BLOCK 的版本 (verifier 要求 CORE 單元必須是 PLACED)
+static string macro_name(int w, bool fixed = false) { return "SYNW" + to_string(w) + (fixed ? "_FIX" : ""); }
+static int macro_pins(int w) { return min(w, 4) + 1; }  // 輸入 A, B, ... 加一個輸出 Y
+static string pin_name(int w, int k) { return k == macro_pins(w) - 1 ? "Y" : string(1, char('A' + k)); }
+
+static void write_lef(const string& path, const Options& opt) {
+  Out os(path);
+  os << "VERSION 5.8 ;\nBUSBITCHARS \"[]\" ;\nDIVIDERCHAR \"/\" ;\n\n";
+  os << "UNITS\n  DATABASE MICRONS " << kDbu << " ;\nEND UNITS\n\n";
+  os << "SITE CoreSite\n  CLASS CORE ;\n  SIZE 0.1 BY 1.2 ;\nEND CoreSite\n\n";
+  for (const auto& [w, p] : opt.widths)
+  for (bool fixed : {false, true}) {
+    if (fixed && opt.fixed <= 0) continue;
+    char size[64];
+    snprintf(size, sizeof(size), "%.6f BY %.6f", w * (double)kSiteW / kDbu, (double)kSiteH / kDbu);
+    string name = macro_name(w, fixed);
+    os << "MACRO " << name << (fixed ? "\n    CLASS BLOCK ;" : "\n    CLASS CORE ;") << "\n    ORIGIN 0.000000 0.000000 ;\n"
+       << "    SIZE " << size << " ;\n    SYMMETRY X Y ;\n    SITE CoreSite ;\n";
+    for (int k = 0; k < macro_pins(w); ++k) {
+      string pin = pin_name(w, k);
+      char rect[96];
+      double x = (k + 0.5) * w * (double)kSiteW / kDbu / macro_pins(w);
+      snprintf(rect, sizeof(rect), "%.6f 0.500000 %.6f 0.700000", x - 0.02, x + 0.02);
+      os << "    PIN " << pin << "\n        DIRECTION " << (pin == "Y" ? "OUTPUT" : "INPUT")
+         << " ;\n        USE SIGNAL ;\n        PORT\n        LAYER Metal1 ;\n        RECT " << rect
+         << " ;\n        END\n    END " << pin << '\n';
+    }
+    os << "END " << name << "\n\n";
+  }
+  os << "END LIBRARY\n";
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: " << argv[0] << " <output prefix> [--cells N] [--util U] [--rows R]\n"
+         << "       [--widths w:p,...] [--nets-per-cell F] [--degree D] [--fanout P]\n"
+         << "       [--fanout-max M] [--fixed P] [--io N] [--perturb S] [--seed S]\n";
+    return 1;
+  }
+  const string prefix = argv[1];
+  Options opt;
+  for (int i = 2; i + 1 < argc; i += 2) {
+    string a = argv[i], v = argv[i + 1];
+    if (a == "--cells") opt.cells = stoll(v);
+    else if (a == "--util") opt.util = stod(v);
+    else if (a == "--rows") opt.rows = stoi(v);
+    else if (a == "--widths") opt.widths = parse_widths(v);
+    else if (a == "--nets-per-cell") opt.nets_per_cell = stod(v);
+    else if (a == "--degree") opt.degree = stod(v);
+    else if (a == "--fanout") opt.fanout = stod(v);
+    else if (a == "--fanout-max") opt.fanout_max = stoi(v);
+    else if (a == "--fixed") opt.fixed = stod(v);
+    else if (a == "--io") opt.io = stoi(v);
+    else if (a == "--perturb") opt.perturb = stoi(v);
+    else if (a == "--seed") opt.seed = stoull(v);
+    else { cerr << "unknown option " << a << '\n'; return 1; }
+  }
+  opt.util = clamp(opt.util, 0.05, 1.0);
+  opt.degree = max(2.0, opt.degree);
+  opt.fanout_max = max(32, opt.fanout_max);
+
+  mt19937_64 rng(opt.seed);
+  auto uni = [&](double lo, double hi) { return uniform_real_distribution<double>(lo, hi)(rng); };
+  auto pick = [&](long long n) { return (long long)uniform_int_distribution<long long>(0, n - 1)(rng); };
+
+  // 1. 單元寬度
+  vector<Cell> cells(opt.cells);
+  {
+    vector<double> p;
+    for (const auto& wp : opt.widths) p.push_back(wp.second);
+    discrete_distribution<int> wd(p.begin(), p.end());
+    for (auto& c : cells) c.w = opt.widths[wd(rng)].first;
+  }
+  long long total_sites = 0;
+  for (const auto& c : cells) total_sites += c.w;
+
+  // 2. die 大小：面積 = 單元面積 / 使用率，接近正方形
+  double area = total_sites * (double)kSiteW * kSiteH / opt.util;
+  int rows = opt.rows > 0 ? opt.rows : max(1, (int)llround(sqrt(area) / kSiteH));
+  long long row_sites = max<long long>(1, (long long)ceil(total_sites / opt.util / rows));
+  int max_w = 0;
+  for (const auto& wp : opt.widths) max_w = max(max_w, wp.first);
+  row_sites = max<long long>(row_sites, max_w);
+
+  // 3. 依序塞進 row，空隙的平均值讓整體使用率接近 util；放不下就換下一條 row
+  {
+    double gap_mean = (1.0 - opt.util) / opt.util;
+    int r = 0;
+    long long col = 0;
+    for (auto& c : cells) {
+      long long gap = (long long)(uni(0, 2 * gap_mean) * c.w);
+      if (col + gap + c.w > row_sites) {
+        ++r;
+        col = 0;
+        gap = 0;
+      }
+      c.row = r;
+      c.col = (int)(col + gap);
+      col += gap + c.w;
+    }
+    rows = max(rows, r + 1);  // 使用率太高時多開 row
+  }
+
+  // 各 row 依 x 排序的單元 (目前的 cells 順序就是 row-major)
+  vector<long long> row_first(rows + 1, (long long)cells.size());
+  for (long long i = (long long)cells.size() - 1; i >= 0; --i) row_first[cells[i].row] = i;
+  for (int r = rows - 1; r >= 0; --r) row_first[r] = min(row_first[r], row_first[r + 1]);
+
+  // 4. net：以 seed 單元為中心，在附近幾條 row 內找 x 接近的單元
+  long long num_nets = max<long long>(1, llround(opt.cells * opt.nets_per_cell));
+  vector<long long> net_start = {0};
+  vector<long long> net_pins;  // 單元索引
+  vector<int> pin_idx;         // 單元的第幾個 pin
+  {
+    geometric_distribution<int> extra(1.0 / (opt.degree - 1.0));
+    vector<long long> members;
+    for (long long n = 0; n < num_nets; ++n) {
+      bool high = uni(0, 1) < opt.fanout;
+      long long deg = high ? 32 + pick(opt.fanout_max - 31) : 2 + min(extra(rng), 30);
+      deg = min<long long>(deg, (long long)cells.size());
+      // 一般 net 在 seed 附近；高扇出 net 的範圍隨 pin 數放大
+      int spread_rows = high ? max(3, (int)sqrt((double)deg)) : 2;
+      long long spread_sites = high ? 40LL * spread_rows : 40;
+
+      members.clear();
+      long long seed = pick(cells.size());
+      members.push_back(seed);
+      for (int tries = 0; (long long)members.size() < deg && tries < deg * 8; ++tries) {
+        int r = clamp(cells[seed].row + (int)pick(2 * spread_rows + 1) - spread_rows, 0, rows - 1);
+        if (row_first[r] == row_first[r + 1]) continue;
+        long long x = cells[seed].col + pick(2 * spread_sites + 1) - spread_sites;
+        auto b = cells.begin() + row_first[r], e = cells.begin() + row_first[r + 1];
+        auto it = lower_bound(b, e, x, [](const Cell& c, long long v) { return c.col < v; });
+        if (it == e) --it;
+        long long c = it - cells.begin();
+        if (find(members.begin(), members.end(), c) == members.end()) members.push_back(c);
+      }
+      if (members.size() < 2) continue;
+      for (long long c : members) {
+        net_pins.push_back(c);
+        pin_idx.push_back((int)pick(macro_pins(cells[c].w)));
+      }
+      net_start.push_back((long long)net_pins.size());
+    }
+    num_nets = (long long)net_start.size() - 1;
+  }
+
+  // 5. IO pin：平均分佈在 die 邊界上，各接到一條隨機 net
+  const long long die_w = row_sites * kSiteW + 2 * kSiteW * 10, die_h = (long long)rows * kSiteH + 2 * kSiteH;
+  const int x0 = kSiteW * 10, y0 = kSiteH;
+  struct Io { long long x, y, net; };
+  vector<Io> ios;
+  for (int k = 0; k < opt.io; ++k) {
+    long long perim = 2 * (die_w + die_h), t = pick(perim);
+    Io p;
+    if (t < die_w) p = {t, 0, 0};
+    else if ((t -= die_w) < die_h) p = {die_w, t, 0};
+    else if ((t -= die_h) < die_w) p = {die_w - t, die_h, 0};
+    else p = {0, die_h - (t - die_w), 0};
+    p.net = pick(num_nets);
+    ios.push_back(p);
+  }
+
+  // 6. 打亂：同 row、寬度相同、距離 perturb 以內的單元隨機互換
+  //    (不改變佔用的 site，所以仍然合法)
+  if (opt.perturb > 0) {
+    for (int r = 0; r < rows; ++r) {
+      long long b = row_first[r], e = row_first[r + 1];
+      for (long long i = b; i < e; ++i) {
+        long long j = i + pick(2 * opt.perturb + 1) - opt.perturb;
+        if (j < b || j >= e || cells[i].w != cells[j].w) continue;
+        swap(cells[i].col, cells[j].col);
+      }
+    }
+  }
+  for (auto& c : cells) c.fixed = uni(0, 1) < opt.fixed;
+
+  // 7. 輸出
+  write_lef(prefix + ".lef", opt);
+
+  Out os(prefix + ".def");
+  os << "VERSION 5.8 ;\nDIVIDERCHAR \"/\" ;\nBUSBITCHARS \"[]\" ;\nDESIGN synth ;\n";
+  os << "UNITS DISTANCE MICRONS " << kDbu << " ;\n\n";
+  os << "DIEAREA ( 0 0 ) ( " << die_w << ' ' << die_h << " ) ;\n\n";
+  for (int r = 0; r < rows; ++r) {
+    os << "ROW CORE_ROW_" << r << " CoreSite " << x0 << ' ' << (long long)y0 + (long long)r * kSiteH
+       << (r % 2 ? " N" : " FS") << " DO " << row_sites << " BY 1 STEP " << kSiteW << " 0\n;\n";
+  }
+
+  os << "\nCOMPONENTS " << (long long)cells.size() << " ;\n";
+  for (size_t i = 0; i < cells.size(); ++i) {
+    const Cell& c = cells[i];
+    os << "  - inst" << (long long)i << ' ' << macro_name(c.w, c.fixed) << (c.fixed ? "\n    + FIXED ( " : "\n    + PLACED ( ")
+       << x0 + (long long)c.col * kSiteW << ' ' << y0 + (long long)c.row * kSiteH << " ) "
+       << (c.row % 2 ? "N" : "FS") << " ;\n";
+  }
+  os << "END COMPONENTS\n\n";
+
+  os << "PINS " << (long long)ios.size() << " ;\n";
+  for (size_t k = 0; k < ios.size(); ++k) {
+    os << "- io" << (long long)k << " + NET net" << ios[k].net << " + DIRECTION INPUT + USE SIGNAL\n"
+       << "  + PLACED ( " << ios[k].x << ' ' << ios[k].y << " ) N ;\n";
+  }
+  os << "END PINS\n\n";
+
+  // 每條 net 接到的 IO pin
+  vector<vector<long long>> net_io(num_nets);
+  for (size_t k = 0; k < ios.size(); ++k) net_io[ios[k].net].push_back((long long)k);
+
+  os << "NETS " << num_nets << " ;\n";
+  for (long long n = 0; n < num_nets; ++n) {
+    os << "- net" << n << '\n';
+    for (long long k : net_io[n]) os << "( PIN io" << k << " ) ";
+    for (long long p = net_start[n]; p < net_start[n + 1]; ++p) {
+      long long c = net_pins[p];
+      os << "( inst" << c << ' ' << pin_name(cells[c].w, pin_idx[p]) << " ) ";
+    }
+    os << "\n;\n";
+  }
+  os << "END NETS\n\nEND DESIGN\n";
+
+  cerr << prefix << ": " << cells.size() << " cells, " << num_nets << " nets, " << net_pins.size()
+       << " pins, " << rows << " rows x " << row_sites << " sites\n";
+  return 0;
+}
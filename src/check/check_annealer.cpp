@@ -0,0 +1,192 @@
+// Annealer 在隨機的合法擺放上執行，檢查：
+//  - 結束後 RowIndex::violations() == 0 (退火維護的索引與重建的索引都是)
+//  - 最後的 HPWL 不大於輸入，且等於 hpwl_counts
+//  - FIXED 單元與多 row 的 macro 沒有移動
+//  - 固定 epoch 數時 1 個與 N 個執行緒的座標完全相同
+// 版面含 FIXED 單元、多 row 的 macro (可動與 FIXED)、1 ~ 6 site 的混合寬度，
+// 部分 row 分成兩段 ROW (中間有空缺)。
+//   check_annealer [--seed S] [--rounds R] [--threads N]
+#include "check_common.hpp"
+#include "../core/design.hpp"
+#include "../core/hpwl.hpp"
+#include "../core/thread_pool.hpp"
+#include "../placer/annealer.hpp"
+#include "../placer/row_index.hpp"
+
+using namespace std;
+
+static constexpr int kSiteW = 100, kRowH = 1000;
+
+// rows x sites 的版面；row r % 4 == 1 時中間 gap 個 site 沒有 ROW
+static core::Design random_design(mt19937_64& rng, int rows, int sites) {
+  core::Design d;
+  d.units.lef_dbu_per_um = d.units.def_dbu_per_um = 1000;
+  d.setDieArea(0, 0, sites * kSiteW, rows * kRowH);
+  core::Site site;
+  site.name = d.intern("core");
+  site.w_dbu = kSiteW;
+  site.h_dbu = kRowH;
+  d.upsertSite(site);
+
+  auto add_macro = [&](const string& name, int w, int h) {
+    core::Macro m;
+    m.name = d.intern(name);
+    m.site = site.name;
+    m.w_dbu = w * kSiteW;
+    m.h_dbu = h * kRowH;
+    d.upsertMacro(m);
+  };
+  for (int w = 1; w <= 6; ++w) add_macro("W" + to_string(w), w, 1);
+  add_macro("M2", 6, 2);
+  add_macro("M3", 8, 3);
+
+  // ok[r][s]：site 可放置且還沒被佔用
+  vector<vector<char>> ok(rows, vector<char>(sites, 1));
+  for (int r = 0; r < rows; ++r) {
+    auto add_row = [&](int s0, int s1) {
+      core::Row row;
+      row.name = d.intern("ROW_" + to_string(r) + "_" + to_string(s0));
+      row.site = site.name;
+      row.x0 = s0 * kSiteW;
+      row.y0 = r * kRowH;
+      row.nx = s1 - s0;
+      row.ny = 1;
+      row.step_x = kSiteW;
+      d.addRow(row);
+    };
+    if (r % 4 == 1) {
+      const int a = sites / 3 + int(rng() % (sites / 3)), gap = 1 + int(rng() % 3);
+      add_row(0, a);
+      add_row(a + gap, sites);
+      for (int s = a; s < a + gap; ++s) ok[r][s] = 0;
+    } else {
+      add_row(0, sites);
+    }
+  }
+
+  int count = 0;
+  auto place = [&](const string& macro, int r, int s, int w, int h, bool fixed) {
+    if (r + h > rows || s + w > sites) return false;
+    for (int dr = 0; dr < h; ++dr) {
+      for (int ds = 0; ds < w; ++ds) {
+        if (!ok[r + dr][s + ds]) return false;
+      }
+    }
+    for (int dr = 0; dr < h; ++dr) fill(ok[r + dr].begin() + s, ok[r + dr].begin() + s + w, 0);
+    core::Instance inst;
+    char name[16];
+    snprintf(name, sizeof name, "c%05d", count++);
+    inst.name = d.intern(name);
+    inst.macro = d.lookup(macro);
+    inst.x = s * kSiteW;
+    inst.y = r * kRowH;
+    inst.fixed = fixed;
+    d.upsertInstance(inst);
+    return true;
+  };
+
+  // 多 row 的 macro 先放，再逐 row 由左往右放單一 row 高的單元
+  for (int k = rows * sites / 150; k > 0; --k) {
+    const bool tall = rng() % 2;
+    place(tall ? "M3" : "M2", int(rng() % rows), int(rng() % sites), tall ? 8 : 6, tall ? 3 : 2, rng() % 2);
+  }
+  for (int r = 0; r < rows; ++r) {
+    for (int s = 0; s < sites;) {
+      const int w = 1 + int(rng() % 6);
+      if (rng() % 10 < 7 && place("W" + to_string(w), r, s, w, 1, rng() % 12 == 0)) s += w;
+      else ++s;
+    }
+  }
+
+  // net：以編號相近 (位置相近) 的單元為主，少數連到遠處；另外幾個 IO pin
+  for (int p = 0; p < 4; ++p) {
+    core::Pin pin;
+    pin.name = d.intern("io" + to_string(p));
+    pin.net = d.intern("n" + to_string(p));
+    pin.x = p % 2 ? sites * kSiteW : 0;
+    pin.y = int(rng() % rows) * kRowH;
+    d.upsertPin(pin);
+  }
+  const int nets = count;
+  for (int n = 0; n < nets; ++n) {
+    core::Net net;
+    net.name = d.intern("n" + to_string(n));
+    const int deg = 2 + int(rng() % 4);
+    for (int k = 0; k < deg; ++k) {
+      int c = rng() % 8 == 0 ? int(rng() % count) : min(count - 1, max(0, n + int(rng() % 61) - 30));
+      char name[16];
+      snprintf(name, sizeof name, "c%05d", c);
+      net.insts.push_back(d.lookup(name));
+    }
+    sort(net.insts.begin(), net.insts.end());
+    net.insts.erase(unique(net.insts.begin(), net.insts.end()), net.insts.end());
+    if (n < 4) net.pins.push_back(d.lookup("io" + to_string(n)));
+    d.upsertNet(net);
+  }
+  d.buildInstanceNetLists();
+  return d;
+}
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 12, threads = 4;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+    else if (a == "--threads") threads = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"annealer"};
+  mt19937_64 rng(seed);
+  core::ThreadPool serial(1), parallel(threads);
+
+  for (int round = 0; round < rounds; ++round) {
+    const core::Design d = random_design(rng, 8 + int(rng() % 16), 80 + int(rng() % 200));
+    core::Netlist input;
+    input.build(d);
+    const string tag = " (round " + to_string(round) + ", " + to_string(input.num_insts) + " cells)";
+    {
+      RowIndex index;
+      index.build(d, input);
+      r.expect(index.violations() == 0, "generated placement is illegal" + tag);
+    }
+
+    AnnealOptions opt;
+    opt.epochs = 6;
+    opt.moves_per_cell = 20;
+    opt.tile_sites = 16 + int(rng() % 32);
+    opt.tile_rows = 1 + int(rng() % 4);
+    // 0.02 為預設；很高的溫度下大多是變差的提議，結束時會還原成最好的 epoch
+    const double t0[] = {0.02, 0.5, 50};
+    opt.t0_scale = t0[round % 3];
+    opt.seed = rng();
+
+    vector<core::Netlist> results;
+    for (core::ThreadPool* pool : {&serial, &parallel}) {
+      core::Netlist nl = input;
+      RowIndex index;
+      index.build(d, nl);
+      Annealer annealer(nl, index, *pool);
+      const Annealer::Stats st = annealer.run(opt);
+      const string what = (pool == &serial ? " 1 thread" : " " + to_string(threads) + " threads") + tag;
+
+      r.expect(index.violations() == 0, "maintained index has violations" + what);
+      RowIndex rebuilt;
+      rebuilt.build(d, nl);
+      r.expect(rebuilt.violations() == 0, "result has violations" + what);
+      r.expect(st.initial == core::hpwl_counts(input) && st.final == core::hpwl_counts(nl),
+               "reported hpwl " + to_string(st.final) + " != " + to_string(core::hpwl_counts(nl)) + what);
+      r.expect(st.final <= st.initial, "hpwl " + to_string(st.initial) + " -> " + to_string(st.final) + what);
+      bool kept = true;
+      for (int i = 0; i < nl.num_insts && kept; ++i) {
+        if (input.fixed[i] || input.height[i] > kRowH) kept = nl.x[i] == input.x[i] && nl.y[i] == input.y[i];
+      }
+      r.expect(kept, "fixed cell or macro moved" + what);
+      results.push_back(move(nl));
+    }
+    r.expect(results[0].x == results[1].x && results[0].y == results[1].y,
+             "coordinates differ between 1 and " + to_string(threads) + " threads" + tag);
+  }
+  return r.finish();
+}
@@ -0,0 +1,95 @@
+// check/*.cpp 共用：決定性的隨機 netlist 與失敗計數。
+// 每個 check 程式是獨立的 main，全部通過時回傳 0 (make check 逐一執行)。
+#pragma once
+#include <bits/stdc++.h>
+#include "../core/netlist.hpp"
+
+namespace check {
+
+struct Result {
+  std::string name;
+  long long cases = 0;
+  long long failures = 0;
+
+  // cond 為 false 時印出第一批失敗 (之後只計數)
+  bool expect(bool cond, const std::string& what) {
+    ++cases;
+    if (cond) return true;
+    if (++failures <= 10) std::cerr << "[FAIL] " << name << ": " << what << "\n";
+    return false;
+  }
+
+  int finish() const {
+    if (failures) {
+      std::cerr << "[CHECK] " << name << ": " << failures << "/" << cases << " failed\n";
+      return 1;
+    }
+    std::cout << "[CHECK] " << name << ": " << cases << " cases ok\n";
+    return 0;
+  }
+};
+
+// instance -> net 的 CSR (依 net 編號遞增，與 Netlist::build 相同)
+inline void build_inst_nets(core::Netlist& nl) {
+  const int insts = nl.num_insts;
+  nl.inst_start.assign(insts + 1, 0);
+  for (int node : nl.net_pins) {
+    if (node < insts) ++nl.inst_start[node + 1];
+  }
+  for (int i = 0; i < insts; ++i) nl.inst_start[i + 1] += nl.inst_start[i];
+  nl.inst_nets.assign(nl.inst_start[insts], 0);
+  std::vector<int> fill(nl.inst_start.begin(), nl.inst_start.end() - 1);
+  for (int n = 0; n < nl.num_nets; ++n) {
+    for (int k = nl.netBegin(n); k < nl.netEnd(n); ++k) {
+      int node = nl.net_pins[k];
+      if (node < insts) nl.inst_nets[fill[node]++] = n;
+    }
+  }
+}
+
+// 隨機 netlist：insts 個單元 + pins 個 IO pin、nets 條 net。
+// 大多數 net 的 degree 在 [1, max_deg]，少數是高扇出或空的 net；座標在 [-span, span]，
+// 只取 grid 的倍數讓邊界上常有多個 pin (測試計數 / 同值的情況)。
+inline core::Netlist random_netlist(std::mt19937_64& rng, int insts, int pins, int nets, int max_deg,
+                                    int span, int grid = 1) {
+  core::Netlist nl;
+  nl.num_insts = insts;
+  nl.num_pins = pins;
+  nl.num_nets = nets;
+  const int nodes = insts + pins;
+  auto coord = [&]() { return int((long long)(rng() % (2 * span / grid + 1)) * grid - span); };
+  for (int i = 0; i < nodes; ++i) {
+    nl.x.push_back(coord());
+    nl.y.push_back(coord());
+  }
+  nl.fixed.assign(insts, 0);
+  nl.width.assign(insts, grid);
+  nl.height.assign(insts, grid);
+
+  nl.net_start.assign(1, 0);
+  std::vector<int> pick;
+  for (int n = 0; n < nets; ++n) {
+    int deg = (rng() % 32 == 0) ? 1 + int(rng() % std::min(nodes, 8 * max_deg)) : 1 + int(rng() % max_deg);
+    if (rng() % 16 == 0) deg = 0;
+    deg = std::min(deg, nodes);
+    pick.clear();
+    for (int k = 0; k < deg; ++k) pick.push_back(int(rng() % nodes));
+    std::sort(pick.begin(), pick.end());
+    pick.erase(std::unique(pick.begin(), pick.end()), pick.end());
+    nl.net_pins.insert(nl.net_pins.end(), pick.begin(), pick.end());
+    nl.net_start.push_back((int)nl.net_pins.size());
+  }
+
+  build_inst_nets(nl);
+  return nl;
+}
+
+// 在最後加一條 net (例如連到所有單元的 reset net)，並重建 instance -> net
+inline void add_net(core::Netlist& nl, const std::vector<int>& pins) {
+  nl.net_pins.insert(nl.net_pins.end(), pins.begin(), pins.end());
+  nl.net_start.push_back((int)nl.net_pins.size());
+  ++nl.num_nets;
+  build_inst_nets(nl);
+}
+
+} // namespace check
@@ -0,0 +1,118 @@
+// 可分離的成本矩陣與逐項計算比對：
+// CostMatrixBuilder::build 的每一項、CandidateGraph 的每條候選邊都必須等於
+// DetailedPlacer::calculate_cost；候選邊還要包含 module i 目前的 site i。
+// 也以稀疏候選圖跑 assignRegion (含 site 順序打亂、不符合「site i 是 module i 的位置」前提的情況)。
+// site 含重複的 x / y、與 pin 同座標、在所有 pin 的外側等情況。
+//   check_cost_matrix [--seed S] [--rounds R]
+#include "check_common.hpp"
+#include "../core/design.hpp"
+#include "../placer/detailed_placer.hpp"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 200;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"cost_matrix"};
+  mt19937_64 rng(seed);
+  CostMatrixBuilder builder;
+  CandidateGraph graph;
+  vector<long long> cost;
+
+  for (int round = 0; round < rounds; ++round) {
+    const int insts = 2 + int(rng() % 150);
+    const int grid = round % 2 ? 1 : 1000;
+    const int span = grid * (4 + int(rng() % 40));
+    core::Netlist nl = check::random_netlist(rng, insts, int(rng() % 10), int(rng() % 150), 1 + int(rng() % 10),
+                                             span, grid);
+    core::Design design;
+    DetailedPlacer dp(design, nl);
+
+    // module i 的 site i 是目前的位置，其餘 site 隨機 (可能落在 span 外)
+    vector<int> modules;
+    for (int c = 0; c < insts; ++c) {
+      if (rng() % 2) modules.push_back(c);
+    }
+    const int k = (int)modules.size();
+    vector<DetailedPlacer::Pos> sites;
+    for (int c : modules) sites.push_back({nl.x[c], nl.y[c]});
+    const int extra = int(rng() % 40);
+    for (int e = 0; e < extra; ++e) {
+      int x = int(rng() % (3 * span / grid + 1)) * grid - span - span / 2;
+      int y = int(rng() % (3 * span / grid + 1)) * grid - span - span / 2;
+      sites.push_back({x, y});
+    }
+    const int m = (int)sites.size();
+    const string tag = " (round " + to_string(round) + ")";
+
+    builder.build(nl, modules, sites, cost);
+    r.expect(cost.size() == (size_t)k * m, "matrix size" + tag);
+    bool ok = true;
+    for (int i = 0; i < k && ok; ++i) {
+      for (int j = 0; j < m && ok; ++j) {
+        const long long direct = dp.calculate_cost(modules[i], sites[j].x, sites[j].y);
+        ok = r.expect(cost[(size_t)i * m + j] == direct, "cost[" + to_string(i) + "][" + to_string(j) + "] " +
+                                                             to_string(cost[(size_t)i * m + j]) +
+                                                             " != " + to_string(direct) + tag);
+      }
+    }
+
+    if (k == 0) continue;
+    const int K = 1 + int(rng() % 12);
+    graph.build(nl, modules, sites, K, builder);
+    for (int i = 0; i < k; ++i) {
+      bool own = false;
+      for (int e = graph.start[i]; e < graph.start[i + 1]; ++e) {
+        const int j = graph.site[e];
+        own |= (j == i);
+        r.expect(graph.cost[e] == dp.calculate_cost(modules[i], sites[j].x, sites[j].y),
+                 "candidate " + to_string(i) + " -> " + to_string(j) + tag);
+      }
+      r.expect(own, "candidate list of " + to_string(i) + " misses its own site" + tag);
+    }
+
+    // assignRegion 走稀疏候選圖：sites 依 modules 順序時不會比原本差；打亂後仍要是合法指派。
+    // 兩種求解器都要給出完整、不重複的指派，且不低於完整矩陣的最佳值
+    vector<int> assignment, dense;
+    for (int pass = 0; pass < 2; ++pass) {
+      if (pass == 1) shuffle(sites.begin(), sites.end(), rng);
+      dp.candidates = 0;
+      dp.solver = DetailedPlacer::MatchSolver::LAP;
+      dp.assignRegion(modules, sites, dense);
+      long long best = 0, current = 0;
+      for (int i = 0; i < k; ++i) {
+        best += dp.calculate_cost(modules[i], sites[dense[i]].x, sites[dense[i]].y);
+        current += dp.calculate_cost(modules[i], sites[i].x, sites[i].y);
+      }
+      dp.candidates = K;
+      for (auto solver : {DetailedPlacer::MatchSolver::LAP, DetailedPlacer::MatchSolver::MCMF}) {
+        dp.solver = solver;
+        const string what = string(solver == DetailedPlacer::MatchSolver::LAP ? "LAP" : "MCMF") +
+                            (pass ? " shuffled" : " ordered") + tag;
+        if (!r.expect(dp.assignRegion(modules, sites, assignment) && (int)assignment.size() == k,
+                      "sparse assignRegion " + what))
+          continue;
+        vector<char> used(m, 0);
+        bool valid = true;
+        long long total = 0;
+        for (int i = 0; i < k && valid; ++i) {
+          const int j = assignment[i];
+          valid = j >= 0 && j < m && !used[j];
+          if (!valid) break;
+          used[j] = 1;
+          total += dp.calculate_cost(modules[i], sites[j].x, sites[j].y);
+        }
+        if (!r.expect(valid, "sparse assignment " + what)) continue;
+        r.expect(total >= best, "sparse below dense optimum " + what);
+        if (pass == 0) r.expect(total <= current, "sparse worse than current " + what);
+      }
+    }
+  }
+  return r.finish();
+}
@@ -0,0 +1,111 @@
+// DefReader 分塊解析與逐筆解析比對：
+// public1.def 以很小的 chunk_bytes (切出上千個 chunk) 在 1 / N 個執行緒下解析，
+// 名稱 (NameId 與字串)、def_order、座標、net / pin 都要與 chunk_bytes = 0 完全相同。
+// 另外產生兩個合成的 DEF：
+//  - 註解裡有 "; - "、紀錄跨多行：切塊的結果仍要相同
+//  - PROPERTY 字串裡有 "; - "：不能從中間切開 (這種區段改走逐筆解析)
+//   check_def_chunked [--def <DEF>] [--threads N]
+#include "check_common.hpp"
+#include "../core/thread_pool.hpp"
+#include "../io/def_reader.hpp"
+
+using namespace std;
+
+// 兩份 Design 的 DEF 部分完全相同；不同時在 why 寫下第一個差異
+static bool same_design(const core::Design& a, const core::Design& b, string& why) {
+  if (a.names.size() != b.names.size()) return why = "name count", false;
+  for (size_t i = 0; i < a.names.size(); ++i) {
+    if (a.str(core::NameId(i)) != b.str(core::NameId(i))) return why = "name " + to_string(i), false;
+  }
+  if (a.instances.size() != b.instances.size()) return why = "instance count", false;
+  for (size_t i = 0; i < a.instances.size(); ++i) {
+    const core::Instance &p = a.instances[i], &q = b.instances[i];
+    if (p.name != q.name || p.macro != q.macro || p.x != q.x || p.y != q.y || p.orient != q.orient ||
+        p.fixed != q.fixed || p.def_order != q.def_order)
+      return why = "instance " + string(a.str(p.name)), false;
+  }
+  if (a.nets.size() != b.nets.size()) return why = "net count", false;
+  for (size_t i = 0; i < a.nets.size(); ++i) {
+    const core::Net &p = a.nets[i], &q = b.nets[i];
+    if (p.name != q.name || p.insts != q.insts || p.pins != q.pins) return why = "net " + string(a.str(p.name)), false;
+  }
+  if (a.pins.size() != b.pins.size()) return why = "pin count", false;
+  for (size_t i = 0; i < a.pins.size(); ++i) {
+    const core::Pin &p = a.pins[i], &q = b.pins[i];
+    if (p.name != q.name || p.net != q.net || p.x != q.x || p.y != q.y) return why = "pin " + string(a.str(p.name)), false;
+  }
+  return true;
+}
+
+static void compare(check::Result& r, const string& path, const string& what, core::ThreadPool& pool) {
+  core::Design ref;
+  io::DefReader ref_reader;
+  ref_reader.chunk_bytes = 0;
+  ref_reader.read(path, ref);
+  for (size_t chunk : {size_t(64), size_t(4096), size_t(65536)}) {
+    for (bool parallel : {false, true}) {
+      core::Design d;
+      io::DefReader reader;
+      reader.chunk_bytes = chunk;
+      if (parallel) reader.pool = &pool;
+      reader.read(path, d);
+      string why;
+      r.expect(same_design(ref, d, why), what + " chunk " + to_string(chunk) + (parallel ? " threads " : " serial ") +
+                                             why);
+    }
+  }
+}
+
+// COMPONENTS / NETS / PINS 各約 n 筆；with_strings 時每個單元帶一個含 "; - " 的 PROPERTY
+static string synthetic_def(int n, bool with_strings) {
+  ostringstream os;
+  os << "VERSION 5.8 ;\nDESIGN synth ;\nUNITS DISTANCE MICRONS 2000 ;\nDIEAREA ( 0 0 ) ( 100000 100000 ) ;\n";
+  os << "COMPONENTS " << n << " ;\n";
+  for (int i = 0; i < n; ++i) {
+    os << "- c" << i << " M" << i % 5;
+    if (i % 3 == 0) os << "\n    # comment ; - fake" << i << " M0 ;\n   ";
+    if (with_strings && i % 2 == 0) os << " + PROPERTY note \"a ; - c" << i + 1 << " M1 ; b\"";
+    os << " + " << (i % 11 == 0 ? "FIXED" : "PLACED") << " ( " << i * 200 << " " << (i % 40) * 2400 << " ) "
+       << (i % 2 ? "FS" : "N") << " ;\n";
+  }
+  os << "END COMPONENTS\n";
+  os << "PINS " << n / 4 << " ;\n";
+  for (int i = 0; i < n / 4; ++i) os << "- p" << i << " + NET n" << i << " + PLACED ( 0 " << i << " ) N ;\n";
+  os << "END PINS\n";
+  os << "NETS " << n << " ;\n";
+  for (int i = 0; i < n; ++i) {
+    os << "- n" << i << " ( c" << i << " A )";
+    if (i + 1 < n) os << " ( c" << i + 1 << " B )";
+    if (i < n / 4) os << " ( PIN p" << i << " )";
+    os << " # ; - fake\n  + USE SIGNAL ;\n";
+  }
+  os << "END NETS\nEND DESIGN\n";
+  return os.str();
+}
+
+int main(int argc, char** argv) {
+  string def = "../testcase/public1.def";
+  int threads = 4;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--def") def = argv[i + 1];
+    else if (a == "--threads") threads = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"def_chunked"};
+  core::ThreadPool pool(threads);
+  compare(r, def, def, pool);
+
+  const char* tmp = getenv("TMPDIR");
+  const string dir = tmp ? tmp : "/tmp";
+  for (bool with_strings : {false, true}) {
+    const string path = dir + "/check_def_chunked_" + to_string(getpid()) + ".def";
+    {
+      ofstream os(path);
+      os << synthetic_def(3000, with_strings);
+    }
+    compare(r, path, with_strings ? "synthetic with strings" : "synthetic", pool);
+    remove(path.c_str());
+  }
+  return r.finish();
+}
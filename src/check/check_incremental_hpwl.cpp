@@ -0,0 +1,91 @@
+// IncrementalHpwl 與全量 HPWL 比對：
+// 隨機的移動組 (1 ~ 20 個單元，含 > 8 個時改掃 net 的路徑)、交換、移到其他 pin 的座標
+// (讓邊界上有多個 pin)，試算的 delta 必須等於套用前後 hpwl_counts 的差；
+// commit 之後的 total 與每條 net 的 box 也要與全量計算相同。
+//   check_incremental_hpwl [--seed S] [--rounds R]
+#include "check_common.hpp"
+#include "../core/hpwl.hpp"
+#include "../placer/incremental_hpwl.hpp"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 100;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"incremental_hpwl"};
+  mt19937_64 rng(seed);
+  vector<IncrementalHpwl::Move> moves;
+  vector<int> pick;
+
+  for (int round = 0; round < rounds; ++round) {
+    const int insts = 2 + int(rng() % 200);
+    const int grid = round % 2 ? 1 : 1000;
+    const int span = grid * (4 + int(rng() % 60));
+    core::Netlist nl = check::random_netlist(rng, insts, int(rng() % 10), int(rng() % 200), 1 + int(rng() % 12),
+                                             span, grid);
+    IncrementalHpwl inc(nl);
+    r.expect(inc.total() == core::hpwl_counts(nl), "rebuild (round " + to_string(round) + ")");
+
+    for (int step = 0; step < 200; ++step) {
+      const string tag = " (round " + to_string(round) + ", step " + to_string(step) + ")";
+      const long long before = core::hpwl_counts(nl);
+      long long delta;
+      moves.clear();
+      if (rng() % 4 == 0) {
+        const int a = int(rng() % insts), b = int(rng() % insts);
+        delta = inc.delta_swap(a, b);
+        if (a != b) {
+          moves.push_back({a, nl.x[b], nl.y[b]});
+          moves.push_back({b, nl.x[a], nl.y[a]});
+        }
+      } else {
+        const int count = 1 + int(rng() % min(insts, 20));
+        pick.clear();
+        while ((int)pick.size() < count) {
+          int c = int(rng() % insts);
+          if (find(pick.begin(), pick.end(), c) == pick.end()) pick.push_back(c);
+        }
+        for (int c : pick) {
+          // 一半移到某個節點目前的座標 (邊界同值)，一半隨機
+          if (rng() % 2) {
+            int o = int(rng() % nl.numNodes());
+            moves.push_back({c, nl.x[o], nl.y[o]});
+          } else {
+            int x = int(rng() % (2 * span / grid + 1)) * grid - span;
+            int y = int(rng() % (2 * span / grid + 1)) * grid - span;
+            moves.push_back({c, x, y});
+          }
+        }
+        delta = inc.delta_moves(moves);
+      }
+
+      // 在副本上套用移動再全量計算
+      core::Netlist moved = nl;
+      for (const auto& m : moves) {
+        moved.x[m.inst] = m.x;
+        moved.y[m.inst] = m.y;
+      }
+      const long long expect = core::hpwl_counts(moved) - before;
+      r.expect(delta == expect, "delta " + to_string(delta) + " != " + to_string(expect) + tag);
+
+      if (rng() % 2) {
+        inc.commit();
+        r.expect(inc.total() == core::hpwl_counts(nl), "total after commit" + tag);
+        r.expect(nl.x == moved.x && nl.y == moved.y, "coordinates after commit" + tag);
+      }
+      // 不 commit 時下一步的試算以目前座標為準，試算殘留的狀態會讓下一步的 delta 不符
+    }
+
+    for (int n = 0; n < nl.num_nets; ++n) {
+      if (!r.expect(inc.net_cost(n) == core::net_hpwl(nl, n), "net " + to_string(n) + " (round " + to_string(round) + ")"))
+        break;
+    }
+  }
+  return r.finish();
+}
@@ -0,0 +1,117 @@
+// 指派求解器與 MCMF 比對最佳成本：
+//  - dense：LinearAssignment vs MinCostMaxFlow (完整 k x m)
+//  - sparse：SparseAssignment vs MinCostMaxFlow (隨機候選邊)，可行性也必須一致
+// 成本刻意取小範圍讓同成本的解很多；指派本身也要合法 (column 不重複、成本加總相符)。
+//   check_lap_mcmf [--seed S] [--rounds R]
+#include "check_common.hpp"
+#include "../placer/lap_solver.hpp"
+#include "../placer/min_cost_flow.hpp"
+
+using namespace std;
+
+// source 0 -> row 1..k -> column k+1..k+m -> sink；回傳 (flow, cost)
+static pair<int, long long> mcmf_solve(MinCostMaxFlow& mcmf, const vector<int>& start, const vector<int>& col,
+                                       const vector<long long>& cost, int k, int m) {
+  const int S = 0, T = k + m + 1;
+  mcmf.reset(T + 1, S, T);
+  for (int i = 0; i < k; ++i) mcmf.add_edge(S, i + 1, 1, 0);
+  for (int j = 0; j < m; ++j) mcmf.add_edge(k + 1 + j, T, 1, 0);
+  for (int i = 0; i < k; ++i) {
+    for (int e = start[i]; e < start[i + 1]; ++e) mcmf.add_edge(i + 1, k + 1 + col[e], 1, cost[e]);
+  }
+  return mcmf.solve();
+}
+
+// 指派合法且成本加總等於 expect
+static bool valid(const vector<int>& row_to_col, const vector<int>& start, const vector<int>& col,
+                  const vector<long long>& cost, int m, long long expect) {
+  vector<char> used(m, 0);
+  long long total = 0;
+  for (int i = 0; i < (int)row_to_col.size(); ++i) {
+    const int j = row_to_col[i];
+    if (j < 0 || j >= m || used[j]) return false;
+    used[j] = 1;
+    long long c = -1;
+    for (int e = start[i]; e < start[i + 1]; ++e) {
+      if (col[e] == j) { c = cost[e]; break; }
+    }
+    if (c < 0) return false;
+    total += c;
+  }
+  return total == expect;
+}
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 500;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"lap_mcmf"};
+  mt19937_64 rng(seed);
+  LinearAssignment lap;
+  SparseAssignment sparse;
+  MinCostMaxFlow mcmf(2, 0, 1);
+  vector<int> start, col, row_to_col;
+  vector<long long> cost;
+
+  for (int round = 0; round < rounds; ++round) {
+    const int k = 1 + int(rng() % 40);
+    const int m = k + int(rng() % 30);
+    const long long range = (round % 3 == 0) ? 4 : 1000000;
+    const string tag = " (round " + to_string(round) + ", k " + to_string(k) + ", m " + to_string(m) + ")";
+
+    // dense：CSR 形式的完整矩陣，與 row-major 的 cost 相同
+    start.assign(1, 0);
+    col.clear();
+    cost.clear();
+    for (int i = 0; i < k; ++i) {
+      for (int j = 0; j < m; ++j) {
+        col.push_back(j);
+        cost.push_back((long long)(rng() % range));
+      }
+      start.push_back((int)col.size());
+    }
+    pair<int, long long> flow = mcmf_solve(mcmf, start, col, cost, k, m);
+    long long got = lap.solve(cost.data(), k, m, row_to_col);
+    r.expect(flow.first == k, "dense MCMF flow" + tag);
+    r.expect(got == flow.second, "dense LAP " + to_string(got) + " != MCMF " + to_string(flow.second) + tag);
+    r.expect(valid(row_to_col, start, col, cost, m, got), "dense LAP assignment" + tag);
+
+    // sparse：每個 row 隨機幾個候選 column；一半的回合保證 column i 在 row i 的候選裡 (一定可行)
+    const bool diagonal = round % 2 == 0;
+    const int deg = 1 + int(rng() % 6);
+    start.assign(1, 0);
+    col.clear();
+    cost.clear();
+    vector<int> pick;
+    for (int i = 0; i < k; ++i) {
+      pick.clear();
+      if (diagonal) pick.push_back(i);
+      for (int d = 0; d < deg; ++d) pick.push_back(int(rng() % m));
+      sort(pick.begin(), pick.end());
+      pick.erase(unique(pick.begin(), pick.end()), pick.end());
+      shuffle(pick.begin(), pick.end(), rng);
+      for (int j : pick) {
+        col.push_back(j);
+        cost.push_back((long long)(rng() % range));
+      }
+      start.push_back((int)col.size());
+    }
+    flow = mcmf_solve(mcmf, start, col, cost, k, m);
+    const bool ok = sparse.solve(start.data(), col.data(), cost.data(), k, m, row_to_col);
+    if (!r.expect(ok == (flow.first == k), "sparse feasibility" + tag) || !ok) continue;
+    long long total = 0;
+    for (int i = 0; i < k; ++i) {
+      for (int e = start[i]; e < start[i + 1]; ++e) {
+        if (col[e] == row_to_col[i]) { total += cost[e]; break; }
+      }
+    }
+    r.expect(total == flow.second, "sparse LAP " + to_string(total) + " != MCMF " + to_string(flow.second) + tag);
+    r.expect(valid(row_to_col, start, col, cost, m, flow.second), "sparse LAP assignment" + tag);
+  }
+  return r.finish();
+}
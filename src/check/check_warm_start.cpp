@@ -0,0 +1,98 @@
+// warm start 與從零求解比對最佳成本 (LinearAssignment / SparseAssignment)：
+// init 取冷啟動的解、各 row 的最小成本 column、隨機排列，或含 -1 / 重複 / 超出範圍
+// 的不合法值；成本範圍小時很多邊是 tight，warm start 真的會保留一部分 row。
+//   check_warm_start [--seed S] [--rounds R]
+#include "check_common.hpp"
+#include "../placer/lap_solver.hpp"
+
+using namespace std;
+
+static bool permutation(const vector<int>& row_to_col, int m) {
+  vector<char> used(m, 0);
+  for (int j : row_to_col) {
+    if (j < 0 || j >= m || used[j]) return false;
+    used[j] = 1;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 1000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"warm_start"};
+  mt19937_64 rng(seed);
+  LinearAssignment lap;
+  SparseAssignment sparse;
+  vector<int> cold, warm, init, start, col;
+  vector<long long> cost, sparse_cost;
+
+  for (int round = 0; round < rounds; ++round) {
+    const int k = 1 + int(rng() % 30);
+    const int m = k + int(rng() % 20);
+    const long long range = (round % 2 == 0) ? 3 : 100000;
+    const string tag = " (round " + to_string(round) + ")";
+    cost.resize((size_t)k * m);
+    for (long long& c : cost) c = (long long)(rng() % range);
+
+    const long long best = lap.solve(cost.data(), k, m, cold);
+
+    // init 的種類
+    init.assign(k, -1);
+    switch (round % 4) {
+      case 0: init = cold; break;
+      case 1:
+        for (int i = 0; i < k; ++i) {
+          const long long* row = cost.data() + (size_t)i * m;
+          init[i] = int(min_element(row, row + m) - row);  // 可能重複
+        }
+        break;
+      case 2: {
+        vector<int> perm(m);
+        iota(perm.begin(), perm.end(), 0);
+        shuffle(perm.begin(), perm.end(), rng);
+        copy(perm.begin(), perm.begin() + k, init.begin());
+        break;
+      }
+      default:
+        for (int& j : init) j = int(rng() % (m + 2)) - 1;  // -1 與 m 都不合法
+        break;
+    }
+
+    const long long got = lap.solve(cost.data(), k, m, warm, init.data());
+    r.expect(got == best, "dense warm " + to_string(got) + " != cold " + to_string(best) + tag);
+    r.expect(permutation(warm, m), "dense warm assignment" + tag);
+
+    // sparse：每個 row 保留一部分 column (init 的 column 不一定在候選裡)，column i 一定在
+    start.assign(1, 0);
+    col.clear();
+    sparse_cost.clear();
+    for (int i = 0; i < k; ++i) {
+      for (int j = 0; j < m; ++j) {
+        if (j == i || rng() % 3 == 0) {
+          col.push_back(j);
+          sparse_cost.push_back(cost[(size_t)i * m + j]);
+        }
+      }
+      start.push_back((int)col.size());
+    }
+    r.expect(sparse.solve(start.data(), col.data(), sparse_cost.data(), k, m, cold), "sparse cold feasible" + tag);
+    r.expect(sparse.solve(start.data(), col.data(), sparse_cost.data(), k, m, warm, init.data()),
+             "sparse warm feasible" + tag);
+    long long cold_total = 0, warm_total = 0;
+    for (int i = 0; i < k; ++i) {
+      for (int e = start[i]; e < start[i + 1]; ++e) {
+        if (col[e] == cold[i]) cold_total += sparse_cost[e];
+        if (col[e] == warm[i]) warm_total += sparse_cost[e];
+      }
+    }
+    r.expect(warm_total == cold_total, "sparse warm " + to_string(warm_total) + " != cold " + to_string(cold_total) + tag);
+    r.expect(permutation(warm, m), "sparse warm assignment" + tag);
+  }
+  return r.finish();
+}
@@ -0,0 +1,118 @@
+// WindowScheduler 的著色與固定 net：
+// 隨機 netlist 再加一條連到所有單元的 global net，隨機分成互不重疊的視窗。
+//  - 同一個 batch 內的視窗不共用 degree <= max_net_degree 的 net
+//  - global net 不算衝突：著色與沒有這條 net 時完全相同；max_net_degree = 0 時每個視窗各自一個 batch
+//  - frozen() 的 box 等於 build 當下所有 pin 的 bounding box
+//  - 有固定 net 時 CostMatrixBuilder 與 DetailedPlacer::calculate_cost 仍逐項相同
+//   check_window_scheduler [--seed S] [--rounds R]
+#include "check_common.hpp"
+#include "../core/design.hpp"
+#include "../placer/detailed_placer.hpp"
+#include "../placer/window_scheduler.hpp"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  int rounds = 100;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    string a = argv[i];
+    if (a == "--seed") seed = stoull(argv[i + 1]);
+    else if (a == "--rounds") rounds = stoi(argv[i + 1]);
+  }
+
+  check::Result r{"window_scheduler"};
+  mt19937_64 rng(seed);
+  WindowScheduler plain, global, serial;
+  CostMatrixBuilder builder;
+  vector<long long> cost;
+
+  for (int round = 0; round < rounds; ++round) {
+    const int insts = 100 + int(rng() % 400);
+    const int grid = round % 2 ? 1 : 1000;
+    const int span = grid * (8 + int(rng() % 60));
+    core::Netlist base = check::random_netlist(rng, insts, int(rng() % 10), insts / 2 + int(rng() % insts), 4,
+                                               span, grid);
+    core::Netlist nl = base;
+    vector<int> all(insts);
+    iota(all.begin(), all.end(), 0);
+    check::add_net(nl, all);
+    const int gnet = nl.num_nets - 1;
+    const string tag = " (round " + to_string(round) + ")";
+
+    // 視窗：打亂後切成 1 ~ 8 個單元一段，部分單元不在任何視窗
+    vector<int> perm = all, win_start{0}, win_cells;
+    shuffle(perm.begin(), perm.end(), rng);
+    for (size_t b = 0; b < perm.size();) {
+      const size_t e = min(perm.size(), b + 1 + rng() % 8);
+      if (rng() % 4) {
+        win_cells.insert(win_cells.end(), perm.begin() + b, perm.begin() + e);
+        win_start.push_back((int)win_cells.size());
+      }
+      b = e;
+    }
+    const int nw = (int)win_start.size() - 1;
+
+    plain.build(base, win_start, win_cells);
+    global.build(nl, win_start, win_cells);
+    serial.max_net_degree = 0;
+    serial.build(nl, win_start, win_cells);
+    r.expect(global.colors() == plain.colors(), "global net changes the coloring" + tag);
+    r.expect(serial.numBatches() == nw, "without a cap the global net gives " + to_string(serial.numBatches()) +
+                                            " batches for " + to_string(nw) + " windows" + tag);
+
+    // 同 batch 內不共用會衝突的 net
+    vector<int> net_batch(nl.num_nets, -1), net_win(nl.num_nets, -1);
+    bool free = true;
+    for (int w = 0; w < nw && free; ++w) {
+      const int c = global.colors()[w];
+      for (int k = win_start[w]; k < win_start[w + 1] && free; ++k) {
+        const int inst = win_cells[k];
+        for (int q = nl.instBegin(inst); q < nl.instEnd(inst); ++q) {
+          const int n = nl.inst_nets[q];
+          if (global.frozen().frozen(nl, n)) continue;
+          if (net_batch[n] == c && net_win[n] != w) {
+            free = false;
+            break;
+          }
+          net_batch[n] = c;
+          net_win[n] = w;
+        }
+      }
+    }
+    r.expect(free, "windows in one batch share a net" + tag);
+
+    FrozenNets::Box box;
+    for (int k = nl.netBegin(gnet); k < nl.netEnd(gnet); ++k) box.add(nl.x[nl.net_pins[k]], nl.y[nl.net_pins[k]]);
+    const FrozenNets::Box& got = global.frozen().box[gnet];
+    r.expect(global.frozen().frozen(nl, gnet) && got.xmin == box.xmin && got.xmax == box.xmax &&
+                 got.ymin == box.ymin && got.ymax == box.ymax,
+             "global net box" + tag);
+
+    // 固定 net 的成本：builder 與 calculate_cost 一致
+    if (nw == 0) continue;
+    const int w = int(rng() % nw);
+    vector<int> modules(win_cells.begin() + win_start[w], win_cells.begin() + win_start[w + 1]);
+    vector<DetailedPlacer::Pos> sites;
+    for (int c : modules) sites.push_back({nl.x[c], nl.y[c]});
+    for (int e = int(rng() % 10); e > 0; --e) {
+      // 一部分落在 global net 的 box 外
+      int x = int(rng() % (3 * span / grid + 1)) * grid - span - span / 2;
+      int y = int(rng() % (3 * span / grid + 1)) * grid - span - span / 2;
+      sites.push_back({x, y});
+    }
+    core::Design design;
+    DetailedPlacer dp(design, nl);
+    dp.frozen = &global.frozen();
+    builder.frozen = &global.frozen();
+    builder.build(nl, modules, sites, cost);
+    bool ok = true;
+    for (size_t i = 0; i < modules.size() && ok; ++i) {
+      for (size_t j = 0; j < sites.size() && ok; ++j) {
+        ok = r.expect(cost[i * sites.size() + j] == dp.calculate_cost(modules[i], sites[j].x, sites[j].y),
+                      "frozen cost[" + to_string(i) + "][" + to_string(j) + "]" + tag);
+      }
+    }
+  }
+  return r.finish();
+}
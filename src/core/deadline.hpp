@@ -0,0 +1,44 @@
+#pragma once
+#include <chrono>
+#include <limits>
+
+namespace core {
+
+// 牆上時間的截止點。預設沒有期限 (expired() 永遠為 false)。
+// 可複製，直接放進各個 pass 的 options 裡，由 pass 在工作單位之間檢查。
+class Deadline {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  Deadline() = default;
+
+  // 從 start 起算 seconds 秒
+  static Deadline after(double seconds, Clock::time_point start = Clock::now()) {
+    Deadline d;
+    d.limited_ = true;
+    d.at_ = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    return d;
+  }
+
+  bool limited() const noexcept { return limited_; }
+  bool expired() const noexcept { return limited_ && Clock::now() >= at_; }
+
+  // 剩下的秒數 (過期為負)；沒有期限時為 +inf
+  double remaining() const noexcept {
+    if (!limited_) return std::numeric_limits<double>::infinity();
+    return std::chrono::duration<double>(at_ - Clock::now()).count();
+  }
+
+  // 提早 seconds 秒的截止點
+  Deadline earlier(double seconds) const {
+    Deadline d = *this;
+    d.at_ -= std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    return d;
+  }
+
+private:
+  bool limited_ = false;
+  Clock::time_point at_{};
+};
+
+} // namespace core
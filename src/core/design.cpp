@@ -1,35 +1,16 @@
 #include "design.hpp"
+#include "profiler.hpp"
 
 namespace core {
 
-
-void Design::upsertSite(const Site& s) {
-  sites[s.name] = s;
-}
-
-void Design::upsertMacro(const Macro& m) {
-  macros[m.name] = m;
-}
-
-void Design::upsertInstance(const Instance& i) {
-  instances[i.name] = i;
-}
-
-void Design::upsertNet(const Net& n) {
-  nets[n.name] = n;
-}
-
-void Design::upsertPin(const Pin& p) {
-  pins[p.name] = p;
-}
-
 void Design::buildInstanceNetLists() {
+  PDA_PROF_SCOPE("build.instance_nets");
 
-  for (const auto& [netName, net] : nets) {
-    for (const auto& instName : net.insts) {
-      auto it = instances.find(instName);
-      if (it == instances.end()) continue;
-      it->second.nets.push_back(netName);
+  for (const Net& net : nets) {
+    for (NameId instName : net.insts) {
+      Instance* inst = instances.find(instName);
+      if (!inst) continue;
+      inst->nets.push_back(net.name);
     }
   }
 }
@@ -1,7 +1,9 @@
 #pragma once
-#include <string>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
 #include <vector>
+#include "string_pool.hpp"
 
 namespace core {
 
@@ -10,21 +12,42 @@ struct Units {
   int def_dbu_per_um = 0;
 };
 
+// DEF 的 8 種方向
+enum class Orient : uint8_t { N, S, E, W, FN, FS, FE, FW };
+
+inline std::string_view orient_name(Orient o) noexcept {
+  static constexpr std::string_view names[] = {"N", "S", "E", "W", "FN", "FS", "FE", "FW"};
+  return names[static_cast<int>(o)];
+}
+
+// 不認得的字串回傳 false，o 不變
+inline bool parse_orient(std::string_view s, Orient& o) noexcept {
+  for (int k = 0; k < 8; ++k) {
+    if (orient_name(static_cast<Orient>(k)) == s) {
+      o = static_cast<Orient>(k);
+      return true;
+    }
+  }
+  return false;
+}
+
+// 名稱都是 Design::names 裡的 NameId；互相參照 (macro / site / net ...) 也只存名稱，
+// 所以沒有 LEF 時照樣可以原樣寫回 DEF。
 struct Site {
-  std::string name;
+  NameId name = 0;
   int w_dbu = 0;
   int h_dbu = 0;
 };
 
 struct Macro {
-  std::string name;
-  std::string site;
+  NameId name = 0;
+  NameId site = 0;
   int w_dbu = 0;
   int h_dbu = 0;
   bool sym_x = false;
   bool sym_y = false;
   bool sym_r90 = false;
-  
+
   bool canFlipX() const noexcept { return sym_x; }
   bool canFlipY() const noexcept { return sym_y; }
   bool canRotate90() const noexcept { return sym_r90; }
@@ -32,44 +55,90 @@ struct Macro {
 };
 
 struct Row {
-  std::string name;
-  std::string site;
-  std::string orient;
+  NameId name = 0;
+  NameId site = 0;
+  Orient orient = Orient::N;
   int x0 = 0, y0 = 0;  // 原點 (DEF DBU)
   int nx = 0, ny = 0;  // DO, BY
   int step_x = 0, step_y = 0; // STEP
 };
 
 struct Instance {
-  std::string name;
-  std::string macro;
+  NameId name = 0;
+  NameId macro = 0;
   int x = 0, y = 0;
-  std::string orient;
+  Orient orient = Orient::N;
   bool fixed = false;
-  std::vector<std::string> nets;
+  int def_order = -1;  // 在輸入 DEF COMPONENTS 中的順序，DefWriter 依此輸出
+  std::vector<NameId> nets;
 };
 
 struct Net {
-  std::string name;
-  std::vector<std::string> insts; // 同一條 net 連接的 instances
-  std::vector<std::string> pins; 
+  NameId name = 0;
+  std::vector<NameId> insts; // 同一條 net 連接的 instances
+  std::vector<NameId> pins;
 };
 
 struct Pin {
-  std::string name;
-  std::string net;
+  NameId name = 0;
+  NameId net = 0;
   int x = 0;
   int y = 0;
 };
 
+// 依插入順序存放的表，另以 NameId 直接索引 (index[name] = 位置 + 1，0 表示沒有)
+template <class T>
+class NamedTable {
+public:
+  size_t size() const noexcept { return items_.size(); }
+  bool empty() const noexcept { return items_.empty(); }
+  void reserve(size_t n) { items_.reserve(n); }
+
+  auto begin() noexcept { return items_.begin(); }
+  auto end() noexcept { return items_.end(); }
+  auto begin() const noexcept { return items_.begin(); }
+  auto end() const noexcept { return items_.end(); }
+  T& operator[](size_t k) noexcept { return items_[k]; }
+  const T& operator[](size_t k) const noexcept { return items_[k]; }
+
+  // 找不到 (含 StringPool::npos) 回傳 -1
+  int indexOf(NameId name) const noexcept {
+    return name < index_.size() ? (int)index_[name] - 1 : -1;
+  }
+  T* find(NameId name) noexcept {
+    int k = indexOf(name);
+    return k < 0 ? nullptr : &items_[k];
+  }
+  const T* find(NameId name) const noexcept {
+    int k = indexOf(name);
+    return k < 0 ? nullptr : &items_[k];
+  }
+
+  // 同名的取代原本的內容，位置不變
+  T& upsert(T&& v) {
+    if (v.name >= index_.size()) index_.resize(std::max<size_t>(v.name + 1, index_.size() * 3 / 2), 0);
+    uint32_t& slot = index_[v.name];
+    if (slot) return items_[slot - 1] = std::move(v);
+    items_.push_back(std::move(v));
+    slot = (uint32_t)items_.size();
+    return items_.back();
+  }
+
+private:
+  std::vector<T> items_;
+  std::vector<uint32_t> index_;
+};
 
 class Design {
 public:
   Units units;
 
+  // 所有名稱 (site / macro / row / instance / net / pin) 共用的字串池
+  StringPool names;
+
   // === LEF ===
-  std::unordered_map<std::string, Site> sites;    // macro_name -> Site
-  std::unordered_map<std::string, Macro> macros;  // macro_name -> Macro
+  NamedTable<Site> sites;
+  NamedTable<Macro> macros;
 
   // === DEF ===
   int die_llx = 0;  // 左下角 x
@@ -77,17 +146,25 @@ public:
   int die_urx = 0;  // 右上角 x
   int die_ury = 0;  // 右上角 y
   std::vector<Row> rows;
-  std::unordered_map<std::string, Instance> instances;
-  std::unordered_map<std::string, Net> nets;
-  std::unordered_map<std::string, Pin> pins;
+  NamedTable<Instance> instances;
+  NamedTable<Net> nets;
+  NamedTable<Pin> pins;
 
   // --- APIs ---
+  NameId intern(std::string_view s) { return names.intern(s); }
+  std::string_view str(NameId id) const noexcept { return names.view(id); }
+  // 沒出現過的名稱回傳 StringPool::npos，各表的 find() 會得到 nullptr
+  NameId lookup(std::string_view s) const { return names.find(s); }
+
   void buildInstanceNetLists();
-  void upsertSite(const Site& s);
-  void upsertMacro(const Macro& m);
-  void upsertInstance(const Instance& i);
-  void upsertNet(const Net& n);
-  void upsertPin(const Pin& p);
+  void upsertSite(const Site& s) { sites.upsert(Site(s)); }
+  void upsertMacro(const Macro& m) { macros.upsert(Macro(m)); }
+  void upsertInstance(const Instance& i) { instances.upsert(Instance(i)); }
+  void upsertNet(const Net& n) { nets.upsert(Net(n)); }
+  void upsertPin(const Pin& p) { pins.upsert(Pin(p)); }
+  void upsertInstance(Instance&& i) { instances.upsert(std::move(i)); }
+  void upsertNet(Net&& n) { nets.upsert(std::move(n)); }
+  void upsertPin(Pin&& p) { pins.upsert(std::move(p)); }
 
   void setDieArea(int llx, int lly, int urx, int ury) noexcept {
     die_llx = llx;
@@ -102,4 +179,4 @@ public:
 
 };
 
-} 
\ No newline at end of file
+}
\ No newline at end of file
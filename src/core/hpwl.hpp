@@ -1,40 +1,41 @@
 #pragma once
 #include <limits>
 #include <algorithm>
+#include <iostream>
 #include "design.hpp"
+#include "netlist.hpp"
 
 namespace core {
   inline long long hpwl_counts(const Design& d){
 
     long long ans = 0;
 
-    for (const auto &[netName, net]:d.nets){
+    for (const auto &net:d.nets){
 
       int x_min = std::numeric_limits<int>::max(), x_max = std::numeric_limits<int>::min();
       int y_min = std::numeric_limits<int>::max(), y_max = std::numeric_limits<int>::min();
 
-      for (const auto &instName:net.insts){
-        auto it = d.instances.find(instName);
-        const auto &inst = it -> second;
-        if (it == d.instances.end()) {
+      for (NameId instName:net.insts){
+        const Instance *inst = d.instances.find(instName);
+        if (!inst) {
           // 如果想 debug，可以暫時印出來：
-          std::cerr << "[WARN] net " << netName
-                    << " has unknown inst " << instName << "\n";
+          std::cerr << "[WARN] net " << d.str(net.name)
+                    << " has unknown inst " << d.str(instName) << "\n";
           continue;
         }
-        x_min = std::min(inst.x, x_min);
-        y_min = std::min(inst.y, y_min);
-        x_max = std::max(inst.x, x_max);
-        y_max = std::max(inst.y, y_max);
+        x_min = std::min(inst->x, x_min);
+        y_min = std::min(inst->y, y_min);
+        x_max = std::max(inst->x, x_max);
+        y_max = std::max(inst->y, y_max);
       }
 
-      for (const auto &pinName:net.pins){
-        auto it = d.pins.find(pinName);
-        const auto &pin = it -> second;
-        x_min = std::min(pin.x, x_min);
-        y_min = std::min(pin.y, y_min);
-        x_max = std::max(pin.x, x_max);
-        y_max = std::max(pin.y, y_max);
+      for (NameId pinName:net.pins){
+        const Pin *pin = d.pins.find(pinName);
+        if (!pin) continue;
+        x_min = std::min(pin->x, x_min);
+        y_min = std::min(pin->y, y_min);
+        x_max = std::max(pin->x, x_max);
+        y_max = std::max(pin->y, y_max);
       }
 
       ans += (x_max - x_min) + (y_max - y_min);
@@ -42,4 +43,31 @@ namespace core {
     return ans;
   }
 
-}
\ No newline at end of file
+
+  // 單一 net 的 HPWL，直接走 CSR + SoA 座標
+  inline long long net_hpwl(const Netlist& nl, int n){
+    int b = nl.netBegin(n), e = nl.netEnd(n);
+    if (b == e) return 0;
+
+    int x_min = std::numeric_limits<int>::max(), x_max = std::numeric_limits<int>::min();
+    int y_min = std::numeric_limits<int>::max(), y_max = std::numeric_limits<int>::min();
+
+    for (int k = b; k < e; ++k){
+      int node = nl.net_pins[k];
+      x_min = std::min(nl.x[node], x_min);
+      y_min = std::min(nl.y[node], y_min);
+      x_max = std::max(nl.x[node], x_max);
+      y_max = std::max(nl.y[node], y_max);
+    }
+    return (long long)(x_max - x_min) + (y_max - y_min);
+  }
+
+  inline long long hpwl_counts(const Netlist& nl){
+    long long ans = 0;
+    for (int n = 0; n < nl.num_nets; ++n){
+      ans += net_hpwl(nl, n);
+    }
+    return ans;
+  }
+
+}
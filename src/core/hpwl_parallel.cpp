@@ -0,0 +1,48 @@
+#include "hpwl_parallel.hpp"
+#include "hpwl_simd.hpp"
+#include <algorithm>
+
+namespace core {
+
+// 每個 chunk 的 net 數；夠大才攤得掉排程成本，也讓 chunk 邊界與執行緒數無關
+static constexpr int kNetGrain = 4096;
+
+static long long run(const Netlist& nl, ThreadPool& pool, long long* per_net) {
+  if (nl.num_nets == 0) return 0;
+  const HpwlIsa isa = hpwl_best_isa();
+  std::vector<long long> partial(ThreadPool::num_chunks(nl.num_nets, kNetGrain), 0);
+
+  pool.parallel_for(nl.num_nets, kNetGrain, [&](int b, int e, int) {
+    partial[b / kNetGrain] =
+        hpwl_kernel(isa, nl.net_start.data() + b, nl.net_pins.data(), e - b,
+                    nl.x.data(), nl.y.data(), per_net ? per_net + b : nullptr);
+  });
+
+  long long total = 0;
+  for (long long p : partial) total += p;
+  return total;
+}
+
+long long hpwl_counts_parallel(const Netlist& nl, ThreadPool& pool) {
+  return run(nl, pool, nullptr);
+}
+
+HpwlReport hpwl_report(const Netlist& nl, ThreadPool& pool, int top_n) {
+  HpwlReport r;
+  r.per_net.assign(nl.num_nets, 0);
+  r.total = run(nl, pool, r.per_net.data());
+
+  top_n = std::min(std::max(top_n, 0), nl.num_nets);
+  if (top_n > 0) {
+    std::vector<int> ids(nl.num_nets);
+    for (int n = 0; n < nl.num_nets; ++n) ids[n] = n;
+    auto worse = [&](int a, int b) {
+      return r.per_net[a] != r.per_net[b] ? r.per_net[a] > r.per_net[b] : a < b;
+    };
+    std::partial_sort(ids.begin(), ids.begin() + top_n, ids.end(), worse);
+    r.worst.assign(ids.begin(), ids.begin() + top_n);
+  }
+  return r;
+}
+
+} // namespace core
@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+#include "netlist.hpp"
+#include "thread_pool.hpp"
+
+namespace core {
+
+// 多執行緒 HPWL：net 依固定大小 chunk 切給 pool，
+// 每個 chunk 的部分和依 chunk 順序相加，結果與執行緒數無關。
+long long hpwl_counts_parallel(const Netlist& nl, ThreadPool& pool);
+
+struct HpwlReport {
+  long long total = 0;
+  std::vector<long long> per_net;  // 每條 net 的 HPWL (net ID 索引)
+  std::vector<int> worst;          // HPWL 最大的前 N 條 net，由大到小 (同值依 ID)
+};
+
+// 一次掃描同時得到總和、per-net 陣列與最差的 top_n 條 net
+HpwlReport hpwl_report(const Netlist& nl, ThreadPool& pool, int top_n = 0);
+
+} // namespace core
@@ -0,0 +1,289 @@
+#include "hpwl_simd.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+namespace core {
+
+namespace {
+
+inline long long scalar_net(const int* pins, int b, int e, const int* x, const int* y) {
+  if (b == e) return 0;
+  int xmin = INT_MAX, xmax = INT_MIN, ymin = INT_MAX, ymax = INT_MIN;
+  for (int k = b; k < e; ++k) {
+    int node = pins[k];
+    xmin = std::min(xmin, x[node]);
+    xmax = std::max(xmax, x[node]);
+    ymin = std::min(ymin, y[node]);
+    ymax = std::max(ymax, y[node]);
+  }
+  return (long long)(xmax - xmin) + (ymax - ymin);
+}
+
+long long kernel_scalar(const int* start, const int* pins, int nets, const int* x, const int* y,
+                        long long* per_net) {
+  long long sum = 0;
+  for (int n = 0; n < nets; ++n) {
+    long long h = scalar_net(pins, start[n], start[n + 1], x, y);
+    if (per_net) per_net[n] = h;
+    sum += h;
+  }
+  return sum;
+}
+
+// 把一個 block 的 lane 結果寫到 per_net (高 fanout 的 lane 之後會被覆寫)；
+// x / y 的跨度分開存，和 net_hpwl 一樣在 64-bit 相加
+inline void store_lanes(const int* dx, const int* dy, int count, long long* out) {
+  for (int l = 0; l < count; ++l) out[l] = (long long)dx[l] + dy[l];
+}
+
+// ---------------------------------------------------------------
+// AVX2
+// ---------------------------------------------------------------
+__attribute__((target("avx2")))
+inline long long hsum_epi32_to_64(__m256i v) {
+  __m256i lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v));
+  __m256i hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1));
+  __m256i s = _mm256_add_epi64(lo, hi);
+  alignas(32) long long t[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(t), s);
+  return t[0] + t[1] + t[2] + t[3];
+}
+
+__attribute__((target("avx2")))
+inline int hmin_epi32(__m256i v) {
+  __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+__attribute__((target("avx2")))
+inline int hmax_epi32(__m256i v) {
+  __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(m);
+}
+
+// 高 fanout：net 內一次處理 8 個 pin
+__attribute__((target("avx2")))
+long long wide_net_avx2(const int* pins, int b, int e, const int* x, const int* y) {
+  __m256i xmin = _mm256_set1_epi32(INT_MAX), xmax = _mm256_set1_epi32(INT_MIN);
+  __m256i ymin = xmin, ymax = xmax;
+  int k = b;
+  for (; k + 8 <= e; k += 8) {
+    __m256i node = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pins + k));
+    __m256i gx = _mm256_i32gather_epi32(x, node, 4);
+    __m256i gy = _mm256_i32gather_epi32(y, node, 4);
+    xmin = _mm256_min_epi32(xmin, gx);
+    xmax = _mm256_max_epi32(xmax, gx);
+    ymin = _mm256_min_epi32(ymin, gy);
+    ymax = _mm256_max_epi32(ymax, gy);
+  }
+  int sxmin = hmin_epi32(xmin), sxmax = hmax_epi32(xmax);
+  int symin = hmin_epi32(ymin), symax = hmax_epi32(ymax);
+  for (; k < e; ++k) {
+    int node = pins[k];
+    sxmin = std::min(sxmin, x[node]);
+    sxmax = std::max(sxmax, x[node]);
+    symin = std::min(symin, y[node]);
+    symax = std::max(symax, y[node]);
+  }
+  return (long long)(sxmax - sxmin) + (symax - symin);
+}
+
+__attribute__((target("avx2")))
+long long kernel_avx2(const int* start, const int* pins, int nets, const int* x, const int* y,
+                      long long* per_net) {
+  constexpr int W = 8;
+  const __m256i lane_cap = _mm256_set1_epi32(kLaneMaxDegree);
+  const __m256i zero = _mm256_setzero_si256();
+  long long sum = 0;
+
+  int n = 0;
+  for (; n + W <= nets; n += W) {
+    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(start + n));
+    __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(start + n + 1));
+    __m256i deg = _mm256_sub_epi32(e, s);
+    // 高 fanout 的 lane 在這裡當成 degree 0，之後另外處理
+    __m256i small = _mm256_cmpgt_epi32(_mm256_add_epi32(lane_cap, _mm256_set1_epi32(1)), deg);
+    __m256i ldeg = _mm256_and_si256(deg, small);
+
+    int max_deg = hmax_epi32(ldeg);
+    __m256i xmin = _mm256_set1_epi32(INT_MAX), xmax = _mm256_set1_epi32(INT_MIN);
+    __m256i ymin = xmin, ymax = xmax;
+
+    // inactive lane 的 gather 以目前的 min 當 src，對 min/max 都不造成影響
+    for (int k = 0; k < max_deg; ++k) {
+      __m256i kk = _mm256_set1_epi32(k);
+      __m256i active = _mm256_cmpgt_epi32(ldeg, kk);
+      __m256i idx = _mm256_add_epi32(s, kk);
+      __m256i node = _mm256_mask_i32gather_epi32(zero, pins, idx, active, 4);
+      __m256i gx = _mm256_mask_i32gather_epi32(xmin, x, node, active, 4);
+      __m256i gy = _mm256_mask_i32gather_epi32(ymin, y, node, active, 4);
+      xmin = _mm256_min_epi32(xmin, gx);
+      xmax = _mm256_max_epi32(xmax, gx);
+      ymin = _mm256_min_epi32(ymin, gy);
+      ymax = _mm256_max_epi32(ymax, gy);
+    }
+
+    // x 與 y 的跨度各自加寬成 64-bit 再相加，大座標時 int32 相加會溢位
+    const __m256i valid = _mm256_cmpgt_epi32(ldeg, zero);
+    __m256i dx = _mm256_and_si256(_mm256_sub_epi32(xmax, xmin), valid);
+    __m256i dy = _mm256_and_si256(_mm256_sub_epi32(ymax, ymin), valid);
+    sum += hsum_epi32_to_64(dx) + hsum_epi32_to_64(dy);
+    if (per_net) {
+      alignas(32) int lx[W], ly[W];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lx), dx);
+      _mm256_store_si256(reinterpret_cast<__m256i*>(ly), dy);
+      store_lanes(lx, ly, W, per_net + n);
+    }
+
+    int wide = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(small, _mm256_cmpeq_epi32(zero, zero))));
+    while (wide) {
+      int l = __builtin_ctz(wide);
+      wide &= wide - 1;
+      long long w = wide_net_avx2(pins, start[n + l], start[n + l + 1], x, y);
+      if (per_net) per_net[n + l] = w;
+      sum += w;
+    }
+  }
+  return sum + kernel_scalar(start + n, pins, nets - n, x, y, per_net ? per_net + n : nullptr);
+}
+
+// ---------------------------------------------------------------
+// AVX-512
+// ---------------------------------------------------------------
+__attribute__((target("avx512f")))
+long long wide_net_avx512(const int* pins, int b, int e, const int* x, const int* y) {
+  __m512i xmin = _mm512_set1_epi32(INT_MAX), xmax = _mm512_set1_epi32(INT_MIN);
+  __m512i ymin = xmin, ymax = xmax;
+  for (int k = b; k < e; k += 16) {
+    __mmask16 m = (e - k >= 16) ? (__mmask16)0xFFFF : (__mmask16)((1u << (e - k)) - 1);
+    __m512i node = _mm512_maskz_loadu_epi32(m, pins + k);
+    __m512i gx = _mm512_mask_i32gather_epi32(xmin, m, node, x, 4);
+    __m512i gy = _mm512_mask_i32gather_epi32(ymin, m, node, y, 4);
+    xmin = _mm512_mask_min_epi32(xmin, m, xmin, gx);
+    xmax = _mm512_mask_max_epi32(xmax, m, xmax, gx);
+    ymin = _mm512_mask_min_epi32(ymin, m, ymin, gy);
+    ymax = _mm512_mask_max_epi32(ymax, m, ymax, gy);
+  }
+  return (long long)(_mm512_reduce_max_epi32(xmax) - _mm512_reduce_min_epi32(xmin)) +
+         (_mm512_reduce_max_epi32(ymax) - _mm512_reduce_min_epi32(ymin));
+}
+
+__attribute__((target("avx512f")))
+long long kernel_avx512(const int* start, const int* pins, int nets, const int* x, const int* y,
+                        long long* per_net) {
+  constexpr int W = 16;
+  const __m512i lane_cap = _mm512_set1_epi32(kLaneMaxDegree);
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i acc = _mm512_setzero_si512();  // 8 x int64
+  long long sum = 0;
+
+  int n = 0;
+  for (; n + W <= nets; n += W) {
+    __m512i s = _mm512_loadu_si512(start + n);
+    __m512i e = _mm512_loadu_si512(start + n + 1);
+    __m512i deg = _mm512_sub_epi32(e, s);
+    __mmask16 small = _mm512_cmple_epi32_mask(deg, lane_cap);
+    __m512i ldeg = _mm512_maskz_mov_epi32(small, deg);
+
+    int max_deg = _mm512_reduce_max_epi32(ldeg);
+    __m512i xmin = _mm512_set1_epi32(INT_MAX), xmax = _mm512_set1_epi32(INT_MIN);
+    __m512i ymin = xmin, ymax = xmax;
+
+    for (int k = 0; k < max_deg; ++k) {
+      __m512i kk = _mm512_set1_epi32(k);
+      __mmask16 active = _mm512_cmpgt_epi32_mask(ldeg, kk);
+      __m512i idx = _mm512_add_epi32(s, kk);
+      __m512i node = _mm512_mask_i32gather_epi32(zero, active, idx, pins, 4);
+      __m512i gx = _mm512_mask_i32gather_epi32(xmin, active, node, x, 4);
+      __m512i gy = _mm512_mask_i32gather_epi32(ymin, active, node, y, 4);
+      xmin = _mm512_min_epi32(xmin, gx);
+      xmax = _mm512_max_epi32(xmax, gx);
+      ymin = _mm512_min_epi32(ymin, gy);
+      ymax = _mm512_max_epi32(ymax, gy);
+    }
+
+    // 同 AVX2：x / y 的跨度先加寬成 64-bit 再累加
+    __mmask16 valid = _mm512_cmpgt_epi32_mask(ldeg, zero);
+    __m512i dx = _mm512_maskz_sub_epi32(valid, xmax, xmin);
+    __m512i dy = _mm512_maskz_sub_epi32(valid, ymax, ymin);
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(dx)));
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(dx, 1)));
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(dy)));
+    acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(dy, 1)));
+    if (per_net) {
+      alignas(64) int lx[W], ly[W];
+      _mm512_store_si512(lx, dx);
+      _mm512_store_si512(ly, dy);
+      store_lanes(lx, ly, W, per_net + n);
+    }
+
+    unsigned wide = (unsigned)(__mmask16)~small;
+    while (wide) {
+      int l = __builtin_ctz(wide);
+      wide &= wide - 1;
+      long long w = wide_net_avx512(pins, start[n + l], start[n + l + 1], x, y);
+      if (per_net) per_net[n + l] = w;
+      sum += w;
+    }
+  }
+  sum += _mm512_reduce_add_epi64(acc);
+  return sum + kernel_scalar(start + n, pins, nets - n, x, y, per_net ? per_net + n : nullptr);
+}
+
+HpwlIsa detect_isa() {
+  if (const char* env = std::getenv("PDA_HPWL_ISA")) {
+    if (std::strcmp(env, "scalar") == 0) return HpwlIsa::Scalar;
+    if (std::strcmp(env, "avx2") == 0 && hpwl_isa_supported(HpwlIsa::Avx2)) return HpwlIsa::Avx2;
+    if (std::strcmp(env, "avx512") == 0 && hpwl_isa_supported(HpwlIsa::Avx512)) return HpwlIsa::Avx512;
+  }
+  if (hpwl_isa_supported(HpwlIsa::Avx512)) return HpwlIsa::Avx512;
+  if (hpwl_isa_supported(HpwlIsa::Avx2)) return HpwlIsa::Avx2;
+  return HpwlIsa::Scalar;
+}
+
+} // namespace
+
+bool hpwl_isa_supported(HpwlIsa isa) {
+  switch (isa) {
+    case HpwlIsa::Avx512: return __builtin_cpu_supports("avx512f");
+    case HpwlIsa::Avx2: return __builtin_cpu_supports("avx2");
+    default: return true;
+  }
+}
+
+HpwlIsa hpwl_best_isa() {
+  static const HpwlIsa isa = detect_isa();
+  return isa;
+}
+
+const char* hpwl_isa_name(HpwlIsa isa) {
+  switch (isa) {
+    case HpwlIsa::Avx512: return "avx512";
+    case HpwlIsa::Avx2: return "avx2";
+    default: return "scalar";
+  }
+}
+
+long long hpwl_kernel(HpwlIsa isa, const int* net_start, const int* net_pins,
+                      int num_nets, const int* x, const int* y, long long* per_net) {
+  switch (isa) {
+    case HpwlIsa::Avx512: return kernel_avx512(net_start, net_pins, num_nets, x, y, per_net);
+    case HpwlIsa::Avx2: return kernel_avx2(net_start, net_pins, num_nets, x, y, per_net);
+    default: return kernel_scalar(net_start, net_pins, num_nets, x, y, per_net);
+  }
+}
+
+long long hpwl_counts_simd(const Netlist& nl) {
+  if (nl.num_nets == 0) return 0;
+  return hpwl_kernel(hpwl_best_isa(), nl.net_start.data(), nl.net_pins.data(),
+                     nl.num_nets, nl.x.data(), nl.y.data());
+}
+
+} // namespace core
@@ -0,0 +1,26 @@
+#pragma once
+#include "netlist.hpp"
+
+namespace core {
+
+// HPWL 向量化 kernel，直接吃 Netlist 的 CSR (net_start / net_pins) 與 SoA x[] / y[]。
+//  - 低 fanout 的 net：一個 lane 負責一條 net，一次處理 8 (AVX2) / 16 (AVX-512) 條，
+//    以 masked gather 取座標，逐 pin 做 min/max
+//  - 高 fanout 的 net (degree > kLaneMaxDegree)：另外用 net 內向量化處理
+// 執行期依 CPU 選擇實作；環境變數 PDA_HPWL_ISA=scalar|avx2|avx512 可強制指定。
+enum class HpwlIsa { Scalar, Avx2, Avx512 };
+
+constexpr int kLaneMaxDegree = 16;
+
+HpwlIsa hpwl_best_isa();
+bool hpwl_isa_supported(HpwlIsa isa);
+const char* hpwl_isa_name(HpwlIsa isa);
+
+// per_net 非空時同時寫出每條 net 的 HPWL (大小 num_nets)
+long long hpwl_kernel(HpwlIsa isa, const int* net_start, const int* net_pins,
+                      int num_nets, const int* x, const int* y, long long* per_net = nullptr);
+
+// 以最佳可用 ISA 計算整個 netlist 的 HPWL，結果與 hpwl_counts(nl) 相同
+long long hpwl_counts_simd(const Netlist& nl);
+
+} // namespace core
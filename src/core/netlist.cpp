@@ -0,0 +1,127 @@
+#include "netlist.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+
+namespace core {
+
+// 表中各項依名稱排序後的位置
+template <class T>
+static std::vector<int> sorted_slots(const NamedTable<T>& t, const Design& d) {
+  std::vector<int> slots(t.size());
+  for (size_t k = 0; k < slots.size(); ++k) slots[k] = (int)k;
+  std::sort(slots.begin(), slots.end(), [&](int a, int b) { return d.str(t[a].name) < d.str(t[b].name); });
+  return slots;
+}
+
+void Netlist::build(const Design& d) {
+  PDA_PROF_SCOPE("build.netlist");
+  inst_slot = sorted_slots(d.instances, d);
+  const std::vector<int> net_slot = sorted_slots(d.nets, d);
+  const std::vector<int> pin_slot = sorted_slots(d.pins, d);
+
+  num_insts = (int)inst_slot.size();
+  num_nets = (int)net_slot.size();
+  num_pins = (int)pin_slot.size();
+
+  // Design 表中的位置 -> ID，只在建立期間需要
+  std::vector<int> inst_id(num_insts), pin_id(num_pins);
+
+  x.assign(numNodes(), 0);
+  y.assign(numNodes(), 0);
+  fixed.assign(num_insts, 0);
+  width.assign(num_insts, 0);
+  height.assign(num_insts, 0);
+  inst_names.resize(num_insts);
+  net_names.resize(num_nets);
+  pin_names.resize(num_pins);
+
+  for (int i = 0; i < num_insts; ++i) {
+    const Instance& inst = d.instances[inst_slot[i]];
+    inst_id[inst_slot[i]] = i;
+    inst_names[i] = d.str(inst.name);
+    x[i] = inst.x;
+    y[i] = inst.y;
+    fixed[i] = inst.fixed;
+    if (const Macro* m = d.macros.find(inst.macro)) {
+      width[i] = m->w_dbu;
+      height[i] = m->h_dbu;
+    }
+  }
+
+  for (int p = 0; p < num_pins; ++p) {
+    const Pin& pin = d.pins[pin_slot[p]];
+    pin_id[pin_slot[p]] = p;
+    pin_names[p] = d.str(pin.name);
+    x[num_insts + p] = pin.x;
+    y[num_insts + p] = pin.y;
+  }
+
+  // --- net -> 節點 ---
+  size_t unknown = 0;
+  net_start.assign(num_nets + 1, 0);
+  net_pins.clear();
+  for (int n = 0; n < num_nets; ++n) {
+    const Net& net = d.nets[net_slot[n]];
+    net_names[n] = d.str(net.name);
+    size_t begin = net_pins.size();
+
+    for (NameId name : net.insts) {
+      int k = d.instances.indexOf(name);
+      if (k < 0) { ++unknown; continue; }
+      net_pins.push_back(inst_id[k]);
+    }
+    for (NameId name : net.pins) {
+      int k = d.pins.indexOf(name);
+      if (k < 0) { ++unknown; continue; }
+      net_pins.push_back(num_insts + pin_id[k]);
+    }
+
+    // 同一 instance 可能以多個 pin 連到同一條 net，HPWL 只需要一次
+    std::sort(net_pins.begin() + begin, net_pins.end());
+    net_pins.erase(std::unique(net_pins.begin() + begin, net_pins.end()), net_pins.end());
+    net_start[n + 1] = (int)net_pins.size();
+  }
+
+  if (unknown > 0) {
+    std::cerr << "[WARN] " << unknown
+              << " net terminals reference unknown instances/pins\n";
+  }
+
+  // --- instance -> net (counting sort，net ID 自然遞增且不重複) ---
+  inst_start.assign(num_insts + 1, 0);
+  for (int node : net_pins) {
+    if (node < num_insts) ++inst_start[node + 1];
+  }
+  for (int i = 0; i < num_insts; ++i) inst_start[i + 1] += inst_start[i];
+
+  inst_nets.assign(inst_start[num_insts], 0);
+  std::vector<int> fill(inst_start.begin(), inst_start.end() - 1);
+  for (int n = 0; n < num_nets; ++n) {
+    for (int k = net_start[n]; k < net_start[n + 1]; ++k) {
+      int node = net_pins[k];
+      if (node < num_insts) inst_nets[fill[node]++] = n;
+    }
+  }
+}
+
+void Netlist::writeBack(Design& d) const {
+  PDA_PROF_SCOPE("write.writeback");
+  // 換到別的 row 的單元要跟著新 row 的方向 (N / FS ...)
+  std::unordered_map<int, Orient> row_orient;
+  for (const Row& r : d.rows) row_orient.emplace(r.y0, r.orient);
+
+  for (int i = 0; i < num_insts; ++i) {
+    if (fixed[i]) continue;
+    Instance& inst = d.instances[inst_slot[i]];
+    if (inst.y != y[i]) {
+      auto it = row_orient.find(y[i]);
+      if (it != row_orient.end()) inst.orient = it->second;
+    }
+    inst.x = x[i];
+    inst.y = y[i];
+  }
+}
+
+} // namespace core
@@ -0,0 +1,66 @@
+#pragma once
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "design.hpp"
+
+namespace core {
+
+// 扁平化的 netlist 視圖，在 Design::buildInstanceNetLists() 之後建一次。
+// instance / net / IO pin 全部換成連續整數 ID，熱迴圈只碰陣列；
+// 名稱只在寫回 Design (DEF 輸出) 時才需要。
+//
+// 節點 (node) 編號：
+//   0 .. num_insts-1                    -> instance
+//   num_insts .. num_insts+num_pins-1   -> IO pin
+// x[] / y[] 以節點編號為索引 (SoA)，pin 位置簡化為 instance 左下角。
+class Netlist {
+public:
+  int num_insts = 0;
+  int num_nets = 0;
+  int num_pins = 0;
+
+  // --- SoA 座標 (DEF DBU)，大小 numNodes() ---
+  std::vector<int> x;
+  std::vector<int> y;
+
+  // --- instance 屬性，大小 num_insts ---
+  std::vector<uint8_t> fixed;
+  std::vector<int> width;   // Macro::w_dbu，找不到 macro 時為 0
+  std::vector<int> height;  // Macro::h_dbu
+
+  // --- CSR: net -> 節點 (同一 net 內已去重) ---
+  std::vector<int> net_start;  // 大小 num_nets + 1
+  std::vector<int> net_pins;
+
+  // --- CSR: instance -> net (已去重) ---
+  std::vector<int> inst_start; // 大小 num_insts + 1
+  std::vector<int> inst_nets;
+
+  // --- 名稱 (指向 Design::names，Design 存在期間有效) ---
+  std::vector<std::string_view> inst_names;
+  std::vector<std::string_view> net_names;
+  std::vector<std::string_view> pin_names;
+
+  // instance ID -> Design::instances 中的位置，寫回時使用
+  std::vector<int> inst_slot;
+
+  // 由 Design 建立 (ID 依名稱排序，結果與 Design 內的存放順序無關)
+  void build(const Design& d);
+
+  // 把 x[] / y[] 寫回 Design::instances (FIXED 的不動)，
+  // 換了 row 的單元方向改成新 row 的 orient
+  void writeBack(Design& d) const;
+
+  int numNodes() const noexcept { return num_insts + num_pins; }
+  bool isInst(int node) const noexcept { return node < num_insts; }
+
+  int netBegin(int n) const noexcept { return net_start[n]; }
+  int netEnd(int n) const noexcept { return net_start[n + 1]; }
+  int netDegree(int n) const noexcept { return net_start[n + 1] - net_start[n]; }
+
+  int instBegin(int i) const noexcept { return inst_start[i]; }
+  int instEnd(int i) const noexcept { return inst_start[i + 1]; }
+};
+
+} // namespace core
@@ -0,0 +1,166 @@
+#include "profiler.hpp"
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace core::prof {
+
+namespace {
+
+constexpr int kMaxIds = 256;  // 每一種最多幾個名稱，超過的直接忽略
+
+// 一個執行緒的計時 / 計數格子；由 registry 持有，執行緒結束後仍保留到報告
+struct Slots {
+  double seconds[kMaxIds] = {};
+  long long calls[kMaxIds] = {};
+  long long counts[kMaxIds] = {};
+};
+
+struct Names {
+  std::vector<std::string> list;
+  std::unordered_map<std::string, int> ids;
+
+  int get(const char* name) {
+    auto it = ids.find(name);
+    if (it != ids.end()) return it->second;
+    if ((int)list.size() >= kMaxIds) return -1;
+    int id = (int)list.size();
+    list.emplace_back(name);
+    ids.emplace(list.back(), id);
+    return id;
+  }
+};
+
+struct Registry {
+  std::mutex m;
+  Names timers, counters, series;
+  std::vector<std::unique_ptr<Slots>> slots;
+  std::vector<std::vector<double>> samples;
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+Slots& local() {
+  thread_local Slots* s = nullptr;
+  if (!s) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.m);
+    r.slots.push_back(std::make_unique<Slots>());
+    s = r.slots.back().get();
+  }
+  return *s;
+}
+
+void write_string(std::ostream& os, const std::string& s) {
+  os << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') os << '\\';
+    os << c;
+  }
+  os << '"';
+}
+
+} // namespace
+
+int timer_id(const char* name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  return r.timers.get(name);
+}
+
+int counter_id(const char* name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  return r.counters.get(name);
+}
+
+int series_id(const char* name) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  int id = r.series.get(name);
+  if (id >= (int)r.samples.size()) r.samples.resize(id + 1);
+  return id;
+}
+
+void add_time(int id, double seconds) {
+  if (id < 0) return;
+  Slots& s = local();
+  s.seconds[id] += seconds;
+  ++s.calls[id];
+}
+
+void add_count(int id, long long n) {
+  if (id < 0) return;
+  local().counts[id] += n;
+}
+
+void add_sample(int id, double value) {
+  if (id < 0) return;
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  r.samples[id].push_back(value);
+}
+
+void reset() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+  for (auto& s : r.slots) *s = Slots{};
+  for (auto& v : r.samples) v.clear();
+}
+
+void report_json(std::ostream& os) {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.m);
+
+  const int nt = (int)r.timers.list.size(), nc = (int)r.counters.list.size();
+  std::vector<double> seconds(nt, 0);
+  std::vector<long long> calls(nt, 0), counts(nc, 0);
+  for (const auto& s : r.slots) {
+    for (int i = 0; i < nt; ++i) { seconds[i] += s->seconds[i]; calls[i] += s->calls[i]; }
+    for (int i = 0; i < nc; ++i) counts[i] += s->counts[i];
+  }
+
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+  os << "{\n  \"enabled\": " << (enabled() ? "true" : "false")
+     << ",\n  \"threads\": " << r.slots.size() << ",\n  \"timers\": [";
+  for (int i = 0; i < nt; ++i) {
+    os << (i ? ",\n    " : "\n    ") << "{\"name\": ";
+    write_string(os, r.timers.list[i]);
+    os << ", \"seconds\": " << std::fixed << std::setprecision(6) << seconds[i]
+       << ", \"calls\": " << calls[i] << '}';
+  }
+  os << (nt ? "\n  ]" : "]") << ",\n  \"counters\": {";
+  for (int i = 0; i < nc; ++i) {
+    os << (i ? ",\n    " : "\n    ");
+    write_string(os, r.counters.list[i]);
+    os << ": " << counts[i];
+  }
+  os << (nc ? "\n  }" : "}") << ",\n  \"series\": {";
+  os << std::defaultfloat << std::setprecision(17);
+  for (int i = 0; i < (int)r.series.list.size(); ++i) {
+    os << (i ? ",\n    " : "\n    ");
+    write_string(os, r.series.list[i]);
+    os << ": [";
+    for (size_t k = 0; k < r.samples[i].size(); ++k) os << (k ? ", " : "") << r.samples[i][k];
+    os << ']';
+  }
+  os << (r.series.list.empty() ? "}" : "\n  }") << "\n}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void write_json(const std::string& path) {
+  std::ofstream os(path, std::ios::trunc);
+  if (!os.is_open()) throw std::runtime_error("Cannot open profile output: " + path);
+  report_json(os);
+}
+
+} // namespace core::prof
@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <ostream>
+#include <string>
+
+// ==========================================
+// 內建 profiler：區段計時 / 計數器 / 數列
+// ==========================================
+// 只在定義 PDA_PROFILE 時 (make PROFILE=1) 才有作用，否則巨集展開成空敘述，
+// 熱點裡的計數完全不產生程式碼。
+//   PDA_PROF_SCOPE("parse.def");              // 到區塊結束為止的時間與呼叫次數
+//   PDA_PROF_COUNT("placer.cost_evals", k);   // 計數器加 k
+//   PDA_PROF_SAMPLE("window.pass_gain", g);   // 依序記下一個值 (每個 pass 一次之類)
+// 計時與計數寫在各執行緒自己的格子 (thread_local)，熱點上不需要同步；
+// 報告時才把所有執行緒加總。名稱必須是字串常數，每個呼叫點第一次執行時註冊一次。
+namespace core::prof {
+
+constexpr bool enabled() noexcept {
+#ifdef PDA_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+int timer_id(const char* name);
+int counter_id(const char* name);
+int series_id(const char* name);
+
+void add_time(int id, double seconds);
+void add_count(int id, long long n);
+void add_sample(int id, double value);
+
+// 清空所有計時與計數 (名稱保留)
+void reset();
+
+// {"enabled", "timers": [...], "counters": {...}, "series": {...}}；
+// timers 依第一次註冊的順序，各項是所有執行緒的總和
+void report_json(std::ostream& os);
+void write_json(const std::string& path);
+
+class Scope {
+public:
+  explicit Scope(int id) : id_(id), t0_(std::chrono::steady_clock::now()) {}
+  ~Scope() { add_time(id_, std::chrono::duration<double>(std::chrono::steady_clock::now() - t0_).count()); }
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  int id_;
+  std::chrono::steady_clock::time_point t0_;
+};
+
+} // namespace core::prof
+
+#define PDA_PROF_CAT2(a, b) a##b
+#define PDA_PROF_CAT(a, b) PDA_PROF_CAT2(a, b)
+
+#ifdef PDA_PROFILE
+#define PDA_PROF_SCOPE(name)                                                              \
+  static const int PDA_PROF_CAT(pda_prof_id_, __LINE__) = ::core::prof::timer_id(name);   \
+  ::core::prof::Scope PDA_PROF_CAT(pda_prof_scope_, __LINE__)(PDA_PROF_CAT(pda_prof_id_, __LINE__))
+#define PDA_PROF_COUNT(name, n)                                                           \
+  do {                                                                                    \
+    static const int pda_prof_id = ::core::prof::counter_id(name);                        \
+    ::core::prof::add_count(pda_prof_id, (long long)(n));                                 \
+  } while (0)
+#define PDA_PROF_SAMPLE(name, v)                                                          \
+  do {                                                                                    \
+    static const int pda_prof_id = ::core::prof::series_id(name);                         \
+    ::core::prof::add_sample(pda_prof_id, (double)(v));                                   \
+  } while (0)
+#else
+#define PDA_PROF_SCOPE(name) static_assert(true, "")
+#define PDA_PROF_COUNT(name, n) do {} while (0)
+#define PDA_PROF_SAMPLE(name, v) do {} while (0)
+#endif
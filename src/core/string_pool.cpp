@@ -0,0 +1,88 @@
+#include "string_pool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace core {
+
+static constexpr size_t kChunkBytes = 1 << 20;
+
+StringPool::StringPool() {
+  table_.assign(1024, npos);
+  entries_.push_back({"", 0, hash({})});
+  table_[entries_[0].hash & (table_.size() - 1)] = 0;
+}
+
+// FNV-1a
+uint32_t StringPool::hash(std::string_view s) noexcept {
+  uint32_t h = 2166136261u;
+  for (unsigned char c : s) {
+    h ^= c;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+const char* StringPool::store(std::string_view s) {
+  if (s.size() > left_) {
+    // 太長的字串自己一塊，其餘開新的標準區塊 (上一塊剩下的空間放棄)
+    size_t n = std::max(kChunkBytes, s.size());
+    chunks_.emplace_back(new char[n]);
+    arena_bytes_ += n;
+    cur_ = chunks_.back().get();
+    left_ = n;
+  }
+  char* p = cur_;
+  if (!s.empty()) std::memcpy(p, s.data(), s.size());
+  cur_ += s.size();
+  left_ -= s.size();
+  return p;
+}
+
+void StringPool::rehash(size_t buckets) {
+  table_.assign(buckets, npos);
+  const size_t mask = buckets - 1;
+  for (NameId id = 0; id < entries_.size(); ++id) {
+    size_t b = entries_[id].hash & mask;
+    while (table_[b] != npos) b = (b + 1) & mask;
+    table_[b] = id;
+  }
+}
+
+void StringPool::reserve(size_t n) {
+  entries_.reserve(n);
+  size_t buckets = table_.size();
+  while (buckets < n * 2) buckets *= 2;
+  if (buckets != table_.size()) rehash(buckets);
+}
+
+NameId StringPool::find(std::string_view s) const {
+  const uint32_t h = hash(s);
+  const size_t mask = table_.size() - 1;
+  for (size_t b = h & mask; table_[b] != npos; b = (b + 1) & mask) {
+    const Entry& e = entries_[table_[b]];
+    if (e.hash == h && e.len == s.size() && std::memcmp(e.ptr, s.data(), s.size()) == 0) return table_[b];
+  }
+  return npos;
+}
+
+NameId StringPool::intern(std::string_view s, uint32_t h) {
+  size_t mask = table_.size() - 1;
+  size_t b = h & mask;
+  for (; table_[b] != npos; b = (b + 1) & mask) {
+    const Entry& e = entries_[table_[b]];
+    if (e.hash == h && e.len == s.size() && std::memcmp(e.ptr, s.data(), s.size()) == 0) return table_[b];
+  }
+
+  const NameId id = (NameId)entries_.size();
+  entries_.push_back({store(s), (uint32_t)s.size(), h});
+  table_[b] = id;
+  // 負載超過 1/2 就加倍
+  if (entries_.size() * 2 > table_.size()) rehash(table_.size() * 2);
+  return id;
+}
+
+size_t StringPool::bytes() const noexcept {
+  return arena_bytes_ + entries_.capacity() * sizeof(Entry) + table_.capacity() * sizeof(NameId);
+}
+
+} // namespace core
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace core {
+
+// 名稱的 32-bit handle；0 固定是空字串
+using NameId = uint32_t;
+
+// 字串 interning：每個不同的名稱只存一次，放在 bump-allocated 的大區塊裡
+// (指標不會因為之後的插入而失效)，以 open addressing 的雜湊表去重。
+// 每個名稱的額外成本是 16 bytes 的索引 + 雜湊表的一格。
+class StringPool {
+public:
+  static constexpr NameId npos = 0xFFFFFFFFu;
+
+  StringPool();
+  StringPool(StringPool&&) noexcept = default;
+  StringPool& operator=(StringPool&&) noexcept = default;
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  // 已有的名稱回傳原本的 handle
+  NameId intern(std::string_view s) { return intern(s, hash(s)); }
+  // h 必須是 hash(s)；讓呼叫端可以在別的執行緒先算好
+  NameId intern(std::string_view s, uint32_t h);
+
+  // 找不到回傳 npos
+  NameId find(std::string_view s) const;
+
+  std::string_view view(NameId id) const noexcept {
+    const Entry& e = entries_[id];
+    return {e.ptr, e.len};
+  }
+
+  size_t size() const noexcept { return entries_.size(); }
+
+  // 預先配置 n 個名稱的索引與雜湊表
+  void reserve(size_t n);
+
+  // 字串本身 + 索引 + 雜湊表佔用的位元組
+  size_t bytes() const noexcept;
+
+  static uint32_t hash(std::string_view s) noexcept;
+
+private:
+  struct Entry {
+    const char* ptr;
+    uint32_t len;
+    uint32_t hash;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<NameId> table_;   // 大小為 2 的次方，npos 為空格
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char* cur_ = nullptr;
+  size_t left_ = 0;
+  size_t arena_bytes_ = 0;
+
+  const char* store(std::string_view s);
+  void rehash(size_t buckets);
+};
+
+} // namespace core
@@ -0,0 +1,76 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace core {
+
+ThreadPool::ThreadPool(int threads) {
+  if (threads <= 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (int tid = 1; tid < threads; ++tid) {
+    workers_.emplace_back([this, tid] { worker_loop(tid); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& t : workers_) t.join();
+}
+
+void ThreadPool::run_chunks(int tid) {
+  const int chunks = num_chunks(job_n_, job_grain_);
+  for (int c = next_chunk_.fetch_add(1); c < chunks; c = next_chunk_.fetch_add(1)) {
+    int b = c * job_grain_;
+    int e = std::min(job_n_, b + job_grain_);
+    (*job_)(b, e, tid);
+  }
+}
+
+void ThreadPool::worker_loop(int tid) {
+  unsigned long long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(m_);
+      wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+    run_chunks(tid);
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      if (--running_ == 0) done_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::parallel_for(int n, int grain, const std::function<void(int, int, int)>& fn) {
+  if (n <= 0) return;
+  grain = std::max(1, grain);
+
+  // 只有一個 chunk 或沒有 worker 時直接在呼叫端跑
+  if (workers_.empty() || n <= grain) {
+    for (int b = 0; b < n; b += grain) fn(b, std::min(n, b + grain), 0);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    job_ = &fn;
+    job_n_ = n;
+    job_grain_ = grain;
+    next_chunk_.store(0);
+    running_ = (int)workers_.size();
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  run_chunks(0);
+
+  std::unique_lock<std::mutex> lk(m_);
+  done_.wait(lk, [&] { return running_ == 0; });
+  job_ = nullptr;
+}
+
+} // namespace core
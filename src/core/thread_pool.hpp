@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core {
+
+// 固定大小的 thread pool。呼叫 parallel_for 的執行緒本身也會分擔工作 (tid 0)，
+// 其餘 worker 的 tid 為 1 .. size()-1，可直接拿來索引 per-thread 的暫存。
+// [0, n) 切成大小 grain 的 chunk，由各執行緒以 atomic 計數器動態領取。
+// parallel_for 不可重入 (job 內不要再呼叫同一個 pool)。
+class ThreadPool {
+public:
+  // threads <= 0 代表使用 hardware_concurrency
+  explicit ThreadPool(int threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  int size() const noexcept { return (int)workers_.size() + 1; }
+
+  // fn(begin, end, tid)
+  void parallel_for(int n, int grain, const std::function<void(int, int, int)>& fn);
+
+  // chunk 數量，供呼叫端配置 per-chunk 的結果陣列 (做決定性的 reduction)
+  static int num_chunks(int n, int grain) { return grain <= 0 ? 0 : (n + grain - 1) / grain; }
+
+private:
+  void worker_loop(int tid);
+  void run_chunks(int tid);
+
+  std::vector<std::thread> workers_;
+  std::mutex m_;
+  std::condition_variable wake_, done_;
+  bool stop_ = false;
+  unsigned long long generation_ = 0;
+  int running_ = 0;
+
+  const std::function<void(int, int, int)>* job_ = nullptr;
+  int job_n_ = 0, job_grain_ = 1;
+  std::atomic<int> next_chunk_{0};
+};
+
+} // namespace core
@@ -1,12 +1,52 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include "../core/design.hpp"
+#include "../core/thread_pool.hpp"
+#include "mapped_file.hpp"
 
 namespace io {
 
+// 原始 DEF 的文字 (指向 mmap)，DefWriter / Snapshot 用來拼接輸出
+struct DefText {
+  bool present = false;     // 有原文可用
+  bool components = false;  // 原文有 COMPONENTS 區段 (位於 head 與 tail 之間)
+  std::string_view head, tail;
+  std::string_view comps;   // 原本的 COMPONENTS 區段；沒移動的單元照抄這裡的紀錄
+};
+
 class DefReader {
 public:
+  // 大的 COMPONENTS / NETS / PINS 區段會切塊解析；非空時各塊交給 pool 平行處理
+  // (結果與執行緒數無關)
+  core::ThreadPool* pool = nullptr;
+
+  // 至少 2 * chunk_bytes 的區段才切塊，每塊約 chunk_bytes；0 為一律逐筆解析。
+  // 區段內有 "..." 字串時也改逐筆解析 (切點可能落在字串裡)
+  size_t chunk_bytes = 1 << 20;
+
   void read(const std::string& path, core::Design& d);
+
+  // read() 之後 mmap 保持開啟，DefWriter 直接拼接沒有修改的部分
+  const MappedFile& file() const noexcept { return file_; }
+
+  // COMPONENTS 區段的位元組範圍 [begin, end)：
+  // 從 "COMPONENTS n ;" 那一行的行首到 "END COMPONENTS" 那一行的行尾 (含換行)
+  bool hasComponents() const noexcept { return comp_end_ > comp_begin_; }
+  size_t componentsBegin() const noexcept { return comp_begin_; }
+  size_t componentsEnd() const noexcept { return comp_end_; }
+
+  // 輸入順序記在 Instance::def_order
+
+  DefText text() const noexcept {
+    std::string_view v = file_.view();
+    if (!hasComponents()) return {true, false, v, {}, {}};
+    return {true, true, v.substr(0, comp_begin_), v.substr(comp_end_), v.substr(comp_begin_, comp_end_ - comp_begin_)};
+  }
+
+private:
+  MappedFile file_;
+  size_t comp_begin_ = 0, comp_end_ = 0;
 };
 
 } 
@@ -1,64 +1,241 @@
 #include "def_writer.hpp"
-#include "utils.hpp"
-#include <fstream>
-#include <sstream>
+#include "../core/profiler.hpp"
+#include "tokenizer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
 #include <stdexcept>
+#include <string_view>
 #include <vector>
-#include <algorithm>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 namespace io {
 
-static void write_components_block(std::ostream& os, const core::Design& d) {
+static void append_int(std::string& out, long long v) {
+  char buf[24];
+  auto r = std::to_chars(buf, buf + sizeof(buf), v);
+  out.append(buf, r.ptr);
+}
+
+static void append_placement(std::string& out, const core::Instance& inst) {
+  out += inst.fixed ? "+ FIXED ( " : "+ PLACED ( ";
+  append_int(out, inst.x);
+  out += ' ';
+  append_int(out, inst.y);
+  out += " ) ";
+  out += core::orient_name(inst.orient);
+}
 
-  os << "COMPONENTS " << d.instances.size() << " ;\n";
-  for (const auto& it : d.instances) {
-    const auto& inst = it.second;
-    const std::string& macro  = inst.macro;
-    const std::string orient  = inst.orient;
-    const std::string status = inst.fixed ? "FIXED" : "PLACED";
+static void append_component(std::string& out, const core::Design& d, const core::Instance& inst) {
+  out += "  - ";
+  out += d.str(inst.name);
+  out += ' ';
+  out += d.str(inst.macro);
+  out += "\n    ";
+  append_placement(out, inst);
+  out += " ;\n";
+}
 
-    os << "  - " << inst.name << ' ' << macro << "\n"
-       << "    + " << status << " ( " << inst.x << ' ' << inst.y
-       << " ) " << orient << " ;\n";
+// 依 def_order 放進對應的位置；沒有順序或順序重複的 instance 依名稱排序放進 extra
+static void order_instances(const core::Design& d, std::vector<const core::Instance*>& slots,
+                            std::vector<const core::Instance*>& extra) {
+  slots.assign(d.instances.size(), nullptr);
+  extra.clear();
+  for (const core::Instance& inst : d.instances) {
+    int k = inst.def_order;
+    if (k >= 0 && k < (int)slots.size() && !slots[k]) slots[k] = &inst;
+    else extra.push_back(&inst);
   }
-  os << "END COMPONENTS\n";
+  std::sort(extra.begin(), extra.end(),
+            [&](const core::Instance* a, const core::Instance* b) { return d.str(a->name) < d.str(b->name); });
 }
 
-void DefWriter::write(const std::string& in_def,
-                      const core::Design& d,
-                      const std::string& out_def)
-{
-  std::ifstream fin(in_def);
-  if (!fin.is_open())
-    throw std::runtime_error("Cannot open input DEF: " + in_def);
+// 依輸入順序 (Instance::def_order) 輸出；沒有順序或順序重複的 instance 依名稱排序接在後面。
+// 走訪一次放進對應的位置，不需要逐一以名稱查表
+static void format_components(std::string& out, const core::Design& d) {
+  out += "COMPONENTS ";
+  append_int(out, (long long)d.instances.size());
+  out += " ;\n";
 
-  std::ofstream fout(out_def, std::ios::trunc);
-  if (!fout.is_open())
-    throw std::runtime_error("Cannot open output DEF: " + out_def);
+  std::vector<const core::Instance*> slots, extra;
+  order_instances(d, slots, extra);
+  for (const core::Instance* inst : slots) {
+    if (inst) append_component(out, d, *inst);
+  }
+  for (const core::Instance* inst : extra) append_component(out, d, *inst);
+  out += "END COMPONENTS\n";
+}
+
+// 以原本的 COMPONENTS 區段為底：第 k 筆紀錄對應 def_order == k 的 instance。
+// 沒有移動 (座標、方向、FIXED 與否都相同) 的紀錄原封不動照抄，+ SOURCE / + WEIGHT 等屬性、
+// COVER / UNPLACED 都保留；移動過的只把擺放子句 (+ PLACED|FIXED|COVER ( x y ) orient 或
+// + UNPLACED) 換成新的位置，沒有擺放子句的在 ";" 前補上。
+// 原文中沒有的 instance 依名稱排序接在 END COMPONENTS 之前。
+// 紀錄與 instance 對不上 (名稱不同、區段不完整) 時回傳 false，由呼叫端整段重新輸出。
+static bool splice_components(std::string& out, const core::Design& d, std::string_view src) {
+  std::vector<const core::Instance*> slots, extra;
+  order_instances(d, slots, extra);
+  std::vector<char> written(slots.size(), 0);
 
-  std::string line;
-  bool in_components = false;
-  bool replaced = false;
+  Tokenizer tk(src);
+  if (tk.next() != "COMPONENTS") return false;
+  const std::string_view count = tk.next();
+  tk.skipStatement();
 
-  while (std::getline(fin, line)) {
-    const std::string trimmed = io::trim(line);
+  const size_t mark = out.size();
+  size_t last = 0;
+  auto copy_to = [&](const char* p) {
+    const size_t pos = size_t(p - src.data());
+    out.append(src.data() + last, pos - last);
+    last = pos;
+  };
+  int n = 0;
+  if (!parse_int(count, n) || n != (int)d.instances.size()) {
+    copy_to(count.data());
+    append_int(out, (long long)d.instances.size());
+    last += count.size();
+  }
+
+  int k = 0;
+  const char* end_line = nullptr;
+  for (std::string_view t = tk.next(); !t.empty(); t = tk.next()) {
+    if (t == "END") {
+      end_line = t.data();
+      while (end_line > src.data() && (end_line[-1] == ' ' || end_line[-1] == '\t')) --end_line;
+      break;
+    }
+    if (t != "-") continue;
 
-    if (!in_components && !trimmed.empty() && trimmed.rfind("COMPONENTS", 0) == 0) {
-      in_components = true;
-      write_components_block(fout, d);
-      replaced = true;
-      continue;
+    const core::Instance* inst = k < (int)slots.size() ? slots[k] : nullptr;
+    if (!inst || tk.next() != d.str(inst->name)) {
+      out.resize(mark);
+      return false;
     }
+    written[k++] = 1;
+    tk.next();  // macro
 
-    if (in_components) {
-      if (trimmed.rfind("END COMPONENTS", 0) == 0) {
-        in_components = false;
+    // 擺放子句的範圍 [cb, ce) 與原本的值；沒有子句時 cb = ce = ";" 的位置
+    const char* cb = nullptr;
+    const char* ce = nullptr;
+    bool same = !inst->fixed && inst->x == 0 && inst->y == 0;  // UNPLACED 讀進來是 (0, 0)
+    std::string_view u = tk.next();
+    for (; !u.empty() && u != ";"; u = tk.next()) {
+      if (u != "+") continue;
+      const std::string_view plus = u;
+      u = tk.next();
+      if (u == "PLACED" || u == "FIXED" || u == "COVER") {
+        const bool fixed = u != "PLACED";
+        int x = 0, y = 0;
+        core::Orient o = core::Orient::N;
+        tk.next();  // (
+        const bool ok = parse_int(tk.next(), x) & parse_int(tk.next(), y);
+        tk.next();  // )
+        const std::string_view on = tk.next();
+        same = ok && core::parse_orient(on, o) && fixed == inst->fixed && x == inst->x && y == inst->y &&
+               o == inst->orient;
+        cb = plus.data();
+        ce = on.data() + on.size();
+      } else if (u == "UNPLACED") {
+        cb = plus.data();
+        ce = u.data() + u.size();
+      } else if (u == ";") {
+        break;
       }
-      continue;
     }
+    if (u != ";") {
+      out.resize(mark);
+      return false;
+    }
+    if (same) continue;
+    if (!cb) {
+      copy_to(u.data());
+      append_placement(out, *inst);
+      out += ' ';
+    } else {
+      copy_to(cb);
+      append_placement(out, *inst);
+      last = size_t(ce - src.data());
+    }
+  }
+  if (!end_line) {
+    out.resize(mark);
+    return false;
+  }
+
+  copy_to(end_line);
+  for (size_t j = 0; j < slots.size(); ++j) {
+    if (slots[j] && !written[j]) append_component(out, d, *slots[j]);
+  }
+  for (const core::Instance* inst : extra) append_component(out, d, *inst);
+  out.append(src.data() + last, src.size() - last);
+  return true;
+}
+
+// writev 可能只寫出一部分，迴圈直到全部寫完
+static void write_all(int fd, iovec* iov, int count, const std::string& path) {
+  while (count > 0) {
+    ssize_t n = ::writev(fd, iov, count);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error("Cannot write " + path + ": " + std::strerror(errno));
+    }
+    while (count > 0 && (size_t)n >= iov->iov_len) {
+      n -= (ssize_t)iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+      iov->iov_len -= (size_t)n;
+    }
+  }
+}
+
+void DefWriter::write(const DefText& src,
+                      const core::Design& d,
+                      const std::string& out_def)
+{
+  PDA_PROF_SCOPE("write.def");
+  if (!src.present)
+    throw std::runtime_error("No DEF text to write " + out_def + " from");
+
+  // 輸出大小與原本的區段差不多，先預留避免反覆搬移
+  std::string comps;
+  if (src.components) {
+    comps.reserve(src.comps.empty() ? d.instances.size() * 64 : src.comps.size() + 4096);
+    if (src.comps.empty() || !splice_components(comps, d, src.comps)) format_components(comps, d);
+  }
 
-    fout << line << '\n';
+  iovec iov[3] = {
+    {const_cast<char*>(src.head.data()), src.head.size()},
+    {comps.data(), comps.size()},
+    {const_cast<char*>(src.tail.data()), src.tail.size()},
+  };
+
+  int fd = ::open(out_def.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open output DEF: " + out_def);
+  try {
+    write_all(fd, iov, 3, out_def);
+  } catch (...) {
+    ::close(fd);
+    throw;
   }
+  if (::close(fd) != 0)
+    throw std::runtime_error("Cannot write " + out_def + ": " + std::strerror(errno));
+}
+
+void DefWriter::write(const std::string& in_def,
+                      const core::Design& d,
+                      const std::string& out_def)
+{
+  DefReader src;
+  core::Design scratch;
+  src.read(in_def, scratch);
+  write(src, d, out_def);
 }
 
 } // namespace io
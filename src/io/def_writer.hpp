@@ -1,11 +1,25 @@
 #pragma once
 #include <string>
 #include "../core/design.hpp"
+#include "def_reader.hpp"
 
 namespace io {
 
 class DefWriter {
 public:
+  // 以保留下來的原文拼接：COMPONENTS 之前 / 之後的位元組原封不動；
+  // COMPONENTS 中沒移動的紀錄照抄，移動過的只改擺放子句 (其他屬性保留)。
+  // 整個檔案一次 writev 寫出。
+  // 原文來自 DefReader::text() 或 Snapshot::defText()
+  void write(const DefText& src,
+             const core::Design& d,
+             const std::string& out_def);
+
+  void write(const DefReader& src,
+             const core::Design& d,
+             const std::string& out_def) { write(src.text(), d, out_def); }
+
+  // 相容舊介面：重新讀一次 in_def 取得版面後再寫
   void write(const std::string& in_def,
              const core::Design& d,
              const std::string& out_def);
@@ -1,79 +1,299 @@
 #include "lef_reader.hpp"
+#include "../core/profiler.hpp"
+#include "mapped_file.hpp"
+#include "tokenizer.hpp"
+#include "utils.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace core;
 
 namespace io {
 
-void LefReader::read(const std::string& path, Design& d) {
-  std::ifstream fin(path);
-  if (!fin.is_open())
-    throw std::runtime_error("Cannot open LEF: " + path);
+// "1.400000" (micron) -> DBU，四捨五入避免 1.4 * 2000 = 2799.999 這種誤差
+static int to_dbu(std::string_view s, int dbu_per_um) {
+  double v = 0;
+  std::from_chars(s.data(), s.data() + s.size(), v);
+  return static_cast<int>(std::lround(v * dbu_per_um));
+}
+
+// SIZE w BY h ;
+static void read_size(Tokenizer& tk, int dbu, int& w, int& h) {
+  std::string_view tw = tk.next();
+  tk.next();  // BY
+  std::string_view th = tk.next();
+  w = to_dbu(tw, dbu);
+  h = to_dbu(th, dbu);
+  tk.skipStatement();
+}
 
-  std::string line;
-  std::string current_macro;
-  int dbu = 0;
+// SITE <name> ... END <name>
+static void read_site(Tokenizer& tk, Design& d) {
   Site site;
+  site.name = d.intern(tk.next());
+
+  for (std::string_view t = tk.next(); !t.empty(); t = tk.next()) {
+    if (t == "SIZE") read_size(tk, d.units.lef_dbu_per_um, site.w_dbu, site.h_dbu);
+    else if (t == "END") { tk.next(); break; }
+    else tk.skipStatement();
+  }
+  d.upsertSite(site);
+}
+
+// MACRO <name> ... END <name>
+// 只保留 SIZE / SYMMETRY / SITE，PIN 與 OBS 整塊跳過
+static void read_macro(Tokenizer& tk, Design& d) {
   Macro macro;
+  macro.name = d.intern(tk.next());
 
-  while (std::getline(fin, line)) {
-    std::istringstream iss(line);
-    std::string token;
-    iss >> token;
-    if (token.empty()) continue;
+  for (std::string_view t = tk.next(); !t.empty(); t = tk.next()) {
+    if (t == "SIZE") {
+      read_size(tk, d.units.lef_dbu_per_um, macro.w_dbu, macro.h_dbu);
+    } else if (t == "SYMMETRY") {
+      for (t = tk.next(); !t.empty() && t != ";"; t = tk.next()) {
+        if (t == "X") macro.sym_x = true;
+        else if (t == "Y") macro.sym_y = true;
+        else if (t == "R90") macro.sym_r90 = true;
+      }
+    } else if (t == "SITE") {
+      if (!macro.site) macro.site = d.intern(tk.next());
+      tk.skipStatement();
+    } else if (t == "PIN") {
+      tk.skipSection(tk.next());  // PIN <name> ... END <name>
+    } else if (t == "OBS" || t == "DENSITY") {
+      while (!tk.eof() && tk.next() != "END") {}  // OBS ... END
+    } else if (t == "END") {
+      tk.next();  // <name>
+      break;
+    } else {
+      tk.skipStatement();
+    }
+  }
+  d.upsertMacro(macro);
+}
+
+static void parse_lef(std::string_view text, Design& d) {
+  Tokenizer tk(text);
+
+  for (std::string_view token = tk.next(); !token.empty(); token = tk.next()) {
 
     // ---- UNITS ----
-    if (token == "DATABASE") {
-      std::string tmp;
-      iss >> tmp; // MICRONS
-      iss >> dbu;
-      d.units.lef_dbu_per_um = dbu;
+    if (token == "UNITS") {
+      for (std::string_view t = tk.next(); !t.empty(); t = tk.next()) {
+        if (t == "DATABASE") {
+          tk.next();  // MICRONS
+          d.units.lef_dbu_per_um = tk.nextInt();
+          tk.skipStatement();
+        } else if (t == "END") {
+          tk.next();  // UNITS
+          break;
+        } else {
+          tk.skipStatement();
+        }
+      }
     }
 
-    // ---- SITE ----
-    else if (token == "SITE") {
-      iss >> site.name;
-    }
-    else if (token == "SIZE" && site.name != "" && current_macro.empty()) {
-      double w, h;
-      std::string by;
-      iss >> w >> by >> h; // SIZE 0.1 BY 1.2
-      site.w_dbu = static_cast<int>(w * d.units.lef_dbu_per_um);
-      site.h_dbu = static_cast<int>(h * d.units.lef_dbu_per_um);
-      d.upsertSite(site);
-    }
+    else if (token == "SITE") read_site(tk, d);
+    else if (token == "MACRO") read_macro(tk, d);
 
-    // ---- MACRO ----
-    else if (token == "MACRO") {
-      iss >> current_macro;
-      macro = Macro{};
-      macro.name = current_macro;
+    // ---- 與擺放無關、可能很大的區塊：直接找 END <name> ----
+    else if (token == "LAYER" || token == "VIA" || token == "VIARULE" ||
+             token == "NONDEFAULTRULE") {
+      tk.skipSection(tk.next());
     }
-    else if (token == "SIZE" && !current_macro.empty()) {
-      double w, h;
-      std::string by;
-      iss >> w >> by >> h;
-      macro.w_dbu = static_cast<int>(w * d.units.lef_dbu_per_um);
-      macro.h_dbu = static_cast<int>(h * d.units.lef_dbu_per_um);
+    else if (token == "PROPERTYDEFINITIONS" || token == "SPACING") {
+      tk.skipSection(token);
     }
-    if (token == "SYMMETRY") {
-      std::string sym;
-      while (iss >> sym && sym != ";") {
-        if (sym == "X") macro.sym_x = true;
-        else if (sym == "Y") macro.sym_y = true;
-        else if (sym == "R90") macro.sym_r90 = true;
-      }
+    else if (token == "BEGINEXT") {
+      while (!tk.eof() && tk.next() != "ENDEXT") {}
     }
-    else if (token == "END" && !current_macro.empty()) {
-      std::string endName;
-      iss >> endName;
-      if (endName == current_macro) {
-        d.upsertMacro(macro);
-        current_macro.clear();
-      }
+
+    else if (token == "END") {
+      if (tk.next() == "LIBRARY") break;
     }
+
+    // VERSION / BUSBITCHARS / MANUFACTURINGGRID ... 都是單一敘述
+    else tk.skipStatement();
+  }
+}
+
+// =====================================================
+// 解析結果快取：以檔案內容的 hash 當 key，存成小的二進位檔
+// =====================================================
+// 檔頭：magic (含格式版本) / 原始 LEF 的大小與 digest_bytes / 內容長度。
+// 檔名的 key 相同只代表 hash_bytes 相同，digest 用另一個 hash 才能抓到 key 碰撞；
+// 載入時任何一項不符 (碰撞、格式改版、寫到一半的檔案) 都當成沒有快取。
+namespace {
+
+constexpr char kCacheMagic[8] = {'P', 'D', 'A', 'L', 'E', 'F', '0', '3'};
+
+struct CacheHeader {
+  uint64_t source_size = 0;
+  uint64_t source_digest = 0;
+  uint64_t payload_size = 0;  // 檔頭之後的 bytes 數
+};
+
+void put_i32(std::string& out, int v) { out.append(reinterpret_cast<const char*>(&v), sizeof v); }
+
+void put_str(std::string& out, std::string_view s) {
+  put_i32(out, (int)s.size());
+  out += s;
+}
+
+struct CacheCursor {
+  const char* p;
+  const char* end;
+
+  bool get_i32(int& v) {
+    if (end - p < (long)sizeof v) return false;
+    std::memcpy(&v, p, sizeof v);
+    p += sizeof v;
+    return true;
+  }
+  bool get_str(std::string_view& s) {
+    int n = 0;
+    if (!get_i32(n) || n < 0 || end - p < n) return false;
+    s = std::string_view(p, n);
+    p += n;
+    return true;
   }
+};
+
+std::string cache_path(const std::string& dir, uint64_t key) {
+  char name[32];
+  std::snprintf(name, sizeof name, "/%016llx.lefc", (unsigned long long)key);
+  return dir + name;
+}
+
+std::string serialize(const Design& d, uint64_t source_size, uint64_t source_digest) {
+  std::string out(kCacheMagic, sizeof kCacheMagic);
+  out.append(sizeof(CacheHeader), '\0');
+  const size_t body = out.size();
+  put_i32(out, d.units.lef_dbu_per_um);
+  put_i32(out, (int)d.sites.size());
+  for (const Site& s : d.sites) {
+    put_str(out, d.str(s.name));
+    put_i32(out, s.w_dbu);
+    put_i32(out, s.h_dbu);
+  }
+  put_i32(out, (int)d.macros.size());
+  for (const Macro& m : d.macros) {
+    put_str(out, d.str(m.name));
+    put_str(out, d.str(m.site));
+    put_i32(out, m.w_dbu);
+    put_i32(out, m.h_dbu);
+    put_i32(out, (m.sym_x ? 1 : 0) | (m.sym_y ? 2 : 0) | (m.sym_r90 ? 4 : 0));
+  }
+  CacheHeader h{source_size, source_digest, out.size() - body};
+  std::memcpy(&out[sizeof kCacheMagic], &h, sizeof h);
+  return out;
+}
+
+// 另一個 Design 的 LEF 部分併進 d (名稱重新 intern 到 d 的字串池)
+void merge_lef(const Design& from, Design& d) {
+  d.units.lef_dbu_per_um = from.units.lef_dbu_per_um;
+  for (Site s : from.sites) {
+    s.name = d.intern(from.str(s.name));
+    d.upsertSite(std::move(s));
+  }
+  for (Macro m : from.macros) {
+    m.name = d.intern(from.str(m.name));
+    m.site = d.intern(from.str(m.site));
+    d.upsertMacro(std::move(m));
+  }
+}
+
+bool deserialize(std::string_view data, uint64_t source_size, uint64_t source_digest, Design& d) {
+  const size_t head = sizeof kCacheMagic + sizeof(CacheHeader);
+  if (data.size() < head || std::memcmp(data.data(), kCacheMagic, sizeof kCacheMagic) != 0) return false;
+  CacheHeader h;
+  std::memcpy(&h, data.data() + sizeof kCacheMagic, sizeof h);
+  if (h.source_size != source_size || h.source_digest != source_digest || h.payload_size != data.size() - head)
+    return false;
+
+  CacheCursor c{data.data() + head, data.data() + data.size()};
+  Design tmp;
+  int n = 0;
+  if (!c.get_i32(tmp.units.lef_dbu_per_um) || !c.get_i32(n)) return false;
+  std::string_view name, site;
+  for (int i = 0; i < n; ++i) {
+    Site s;
+    if (!c.get_str(name) || !c.get_i32(s.w_dbu) || !c.get_i32(s.h_dbu)) return false;
+    s.name = tmp.intern(name);
+    tmp.upsertSite(s);
+  }
+  if (!c.get_i32(n)) return false;
+  for (int i = 0; i < n; ++i) {
+    Macro m;
+    int flags = 0;
+    if (!c.get_str(name) || !c.get_str(site) || !c.get_i32(m.w_dbu) ||
+        !c.get_i32(m.h_dbu) || !c.get_i32(flags))
+      return false;
+    m.name = tmp.intern(name);
+    m.site = tmp.intern(site);
+    m.sym_x = flags & 1;
+    m.sym_y = flags & 2;
+    m.sym_r90 = flags & 4;
+    tmp.upsertMacro(m);
+  }
+  if (c.p != c.end) return false;
+
+  merge_lef(tmp, d);
+  return true;
+}
+
+// 先寫暫存檔再 rename，避免並行的 job 讀到寫一半的快取
+void store(const std::string& path, const std::string& bytes) {
+  std::string tmp = path + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+    if (!os.is_open()) return;
+    os.write(bytes.data(), bytes.size());
+    if (!os) { std::remove(tmp.c_str()); return; }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) std::remove(tmp.c_str());
+}
+
+} // namespace
+
+void LefReader::read(const std::string& path, Design& d) {
+  PDA_PROF_SCOPE("parse.lef");
+  MappedFile file;
+  try {
+    file.open(path);
+  } catch (const std::runtime_error&) {
+    throw std::runtime_error("Cannot open LEF: " + path);
+  }
+
+  if (cache_dir.empty()) {
+    parse_lef(file.view(), d);
+    return;
+  }
+
+  const uint64_t key = hash_bytes(file.data(), file.size());
+  const std::string cpath = cache_path(cache_dir, key);
+  const uint64_t digest = digest_bytes(file.data(), file.size());
+
+  struct stat st;
+  if (::stat(cpath.c_str(), &st) == 0 && st.st_size > 0) {
+    try {
+      MappedFile cached(cpath);
+      if (deserialize(cached.view(), file.size(), digest, d)) return;
+    } catch (const std::runtime_error&) {
+      // 快取壞掉就重新解析
+    }
+  }
+
+  Design parsed;
+  parse_lef(file.view(), parsed);
+  ::mkdir(cache_dir.c_str(), 0755);
+  store(cpath, serialize(parsed, file.size(), digest));
+
+  merge_lef(parsed, d);
 }
 }
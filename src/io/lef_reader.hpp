@@ -4,8 +4,13 @@
 
 namespace io {
 
+// 只保留擺放需要的 UNITS / SITE / MACRO (SIZE、SYMMETRY、SITE)，
+// LAYER / VIA / PIN / OBS 等區塊整段跳過。
 class LefReader {
 public:
+  // 非空時，以 LEF 內容的 hash 為 key 在這個目錄快取解析結果
+  std::string cache_dir;
+
   void read(const std::string& path, core::Design& d);
 };
 
@@ -0,0 +1,49 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace io {
+
+void MappedFile::open(const std::string& path) {
+  close();
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(errno));
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ == 0) {  // mmap 不接受長度 0
+    ::close(fd);
+    data_ = "";
+    return;
+  }
+
+  void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    size_ = 0;
+    throw std::runtime_error("Cannot mmap " + path + ": " + std::strerror(errno));
+  }
+  // 讀檔是單向掃描
+  ::madvise(p, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const char*>(p);
+}
+
+void MappedFile::close() noexcept {
+  if (data_ && size_ > 0) ::munmap(const_cast<char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+} // namespace io
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+// 唯讀 mmap 的整個檔案。解構時自動 munmap。
+// 讀檔端直接在這塊記憶體上以 string_view 走訪，不複製任何內容。
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path) { open(path); }
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& o) noexcept { swap(o); }
+  MappedFile& operator=(MappedFile&& o) noexcept { close(); swap(o); return *this; }
+
+  // 失敗時丟 std::runtime_error
+  void open(const std::string& path);
+  void close() noexcept;
+
+  const char* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+  std::string_view view() const noexcept { return {data_, size_}; }
+
+private:
+  void swap(MappedFile& o) noexcept {
+    std::swap(data_, o.data_);
+    std::swap(size_, o.size_);
+  }
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace io
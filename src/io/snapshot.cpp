@@ -0,0 +1,292 @@
+#include "snapshot.hpp"
+#include "../core/profiler.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+using namespace core;
+
+namespace io {
+
+namespace {
+
+constexpr char kSnapMagic[8] = {'P', 'D', 'A', 'S', 'N', 'P', '0', '3'};
+
+// 檔頭：magic 之後的 int32 欄位
+enum Header {
+  H_LEF_DBU, H_DEF_DBU, H_DIE_LLX, H_DIE_LLY, H_DIE_URX, H_DIE_URY,
+  H_STRINGS, H_STRING_BYTES,
+  H_SITES, H_MACROS, H_ROWS, H_INSTS, H_NETS, H_NET_REFS, H_PINS,
+  H_DEF_FLAGS, H_HEAD_BYTES, H_TAIL_BYTES, H_COMP_BYTES,
+  H_COUNT
+};
+
+// 各種紀錄的 int32 個數；名稱是字串表的索引，orient 是 core::Orient 的值
+constexpr int kSiteFields = 3;   // name w h
+constexpr int kMacroFields = 5;  // name site w h sym
+constexpr int kRowFields = 9;    // name site orient x0 y0 nx ny step_x step_y
+constexpr int kInstFields = 7;   // name macro orient x y fixed def_order
+constexpr int kNetFields = 3;    // name #insts #pins (名稱放在 net_refs)
+constexpr int kPinFields = 4;    // name net x y
+
+void put(std::string& out, const void* p, size_t n) { out.append(static_cast<const char*>(p), n); }
+void put_ints(std::string& out, const std::vector<int32_t>& v) { put(out, v.data(), v.size() * sizeof(int32_t)); }
+void pad4(std::string& out) { out.append((4 - out.size() % 4) % 4, '\0'); }
+
+// 讀檔游標：越界即丟例外
+struct Reader {
+  const char* p;
+  const char* end;
+
+  const int32_t* ints(size_t n) {
+    if ((size_t)(end - p) / sizeof(int32_t) < n) throw std::runtime_error("truncated snapshot");
+    const int32_t* r = reinterpret_cast<const int32_t*>(p);
+    p += n * sizeof(int32_t);
+    return r;
+  }
+  std::string_view bytes(size_t n) {
+    if ((size_t)(end - p) < n) throw std::runtime_error("truncated snapshot");
+    std::string_view r(p, n);
+    p += n;
+    return r;
+  }
+  void align4(const char* base) { p += (4 - (p - base) % 4) % 4; }
+};
+
+} // namespace
+
+void Snapshot::save(const std::string& path, const Design& d, const DefText& def) {
+  PDA_PROF_SCOPE("snapshot.save");
+  // 字串表直接用 Design 的字串池，紀錄裡的名稱就是 NameId
+  std::vector<int32_t> sites, macros, rows, insts, nets, net_refs, pins;
+
+  for (const Site& s : d.sites) {
+    sites.insert(sites.end(), {(int32_t)s.name, s.w_dbu, s.h_dbu});
+  }
+  for (const Macro& m : d.macros) {
+    int32_t sym = (m.sym_x ? 1 : 0) | (m.sym_y ? 2 : 0) | (m.sym_r90 ? 4 : 0);
+    macros.insert(macros.end(), {(int32_t)m.name, (int32_t)m.site, m.w_dbu, m.h_dbu, sym});
+  }
+  for (const Row& r : d.rows) {
+    rows.insert(rows.end(), {(int32_t)r.name, (int32_t)r.site, (int32_t)r.orient,
+                             r.x0, r.y0, r.nx, r.ny, r.step_x, r.step_y});
+  }
+  for (const Instance& i : d.instances) {
+    insts.insert(insts.end(), {(int32_t)i.name, (int32_t)i.macro, (int32_t)i.orient,
+                               i.x, i.y, i.fixed ? 1 : 0, i.def_order});
+  }
+  for (const Net& n : d.nets) {
+    nets.insert(nets.end(), {(int32_t)n.name, (int32_t)n.insts.size(), (int32_t)n.pins.size()});
+    net_refs.insert(net_refs.end(), n.insts.begin(), n.insts.end());
+    net_refs.insert(net_refs.end(), n.pins.begin(), n.pins.end());
+  }
+  for (const Pin& p : d.pins) {
+    pins.insert(pins.end(), {(int32_t)p.name, (int32_t)p.net, p.x, p.y});
+  }
+
+  std::string_view head, tail, comps;
+  int32_t def_flags = 0;
+  if (def.present) {
+    def_flags = def.components ? 3 : 1;
+    head = def.head;
+    tail = def.tail;
+    comps = def.comps;
+  }
+
+  // 字串表：offset 陣列 (n + 1 個) + 連續的位元組
+  std::vector<int32_t> offsets(1, 0);
+  size_t string_bytes = 0;
+  const NameId num_strings = (NameId)d.names.size();
+  if (num_strings > (NameId)INT32_MAX) throw std::runtime_error("snapshot string table too large");
+  for (NameId id = 0; id < num_strings; ++id) {
+    std::string_view s = d.str(id);
+    string_bytes += s.size();
+    if (string_bytes > (size_t)INT32_MAX) throw std::runtime_error("snapshot string table too large");
+    offsets.push_back((int32_t)string_bytes);
+  }
+
+  std::vector<int32_t> header(H_COUNT, 0);
+  header[H_LEF_DBU] = d.units.lef_dbu_per_um;
+  header[H_DEF_DBU] = d.units.def_dbu_per_um;
+  header[H_DIE_LLX] = d.die_llx;
+  header[H_DIE_LLY] = d.die_lly;
+  header[H_DIE_URX] = d.die_urx;
+  header[H_DIE_URY] = d.die_ury;
+  header[H_STRINGS] = (int32_t)num_strings;
+  header[H_STRING_BYTES] = (int32_t)string_bytes;
+  header[H_SITES] = (int32_t)d.sites.size();
+  header[H_MACROS] = (int32_t)d.macros.size();
+  header[H_ROWS] = (int32_t)d.rows.size();
+  header[H_INSTS] = (int32_t)d.instances.size();
+  header[H_NETS] = (int32_t)d.nets.size();
+  header[H_NET_REFS] = (int32_t)net_refs.size();
+  header[H_PINS] = (int32_t)d.pins.size();
+  header[H_DEF_FLAGS] = def_flags;
+  if (head.size() > (size_t)INT32_MAX || tail.size() > (size_t)INT32_MAX || comps.size() > (size_t)INT32_MAX)
+    throw std::runtime_error("snapshot DEF text too large");
+  header[H_HEAD_BYTES] = (int32_t)head.size();
+  header[H_TAIL_BYTES] = (int32_t)tail.size();
+  header[H_COMP_BYTES] = (int32_t)comps.size();
+
+  std::string out(kSnapMagic, sizeof kSnapMagic);
+  out.reserve(sizeof kSnapMagic + string_bytes + head.size() + tail.size() + comps.size() +
+              (offsets.size() + sites.size() + macros.size() + rows.size() + insts.size() +
+               nets.size() + net_refs.size() + pins.size()) * sizeof(int32_t) + 64);
+  put_ints(out, header);
+  put_ints(out, offsets);
+  for (NameId id = 0; id < num_strings; ++id) put(out, d.str(id).data(), d.str(id).size());
+  pad4(out);
+  put_ints(out, sites);
+  put_ints(out, macros);
+  put_ints(out, rows);
+  put_ints(out, insts);
+  put_ints(out, nets);
+  put_ints(out, net_refs);
+  put_ints(out, pins);
+  put(out, head.data(), head.size());
+  put(out, tail.data(), tail.size());
+  put(out, comps.data(), comps.size());
+
+  // 先寫暫存檔再 rename，不會留下寫一半的快照
+  std::string tmp = path + ".tmp" + std::to_string(::getpid());
+  {
+    std::ofstream os(tmp, std::ios::binary | std::ios::trunc);
+    if (!os.is_open()) throw std::runtime_error("Cannot open snapshot: " + tmp);
+    os.write(out.data(), out.size());
+    if (!os) {
+      std::remove(tmp.c_str());
+      throw std::runtime_error("Cannot write snapshot: " + tmp);
+    }
+  }
+  if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Cannot rename snapshot to " + path);
+  }
+}
+
+void Snapshot::load(const std::string& path, Design& d) {
+  PDA_PROF_SCOPE("snapshot.load");
+  file_.open(path);
+  const std::string_view data = file_.view();
+  if (data.size() < sizeof kSnapMagic || std::memcmp(data.data(), kSnapMagic, sizeof kSnapMagic) != 0)
+    throw std::runtime_error("Not a snapshot file: " + path);
+
+  Reader rd{data.data() + sizeof kSnapMagic, data.data() + data.size()};
+  const int32_t* h = rd.ints(H_COUNT);
+  for (int k = H_STRINGS; k < H_COUNT; ++k) {
+    if (h[k] < 0) throw std::runtime_error("Corrupt snapshot: " + path);
+  }
+
+  // 字串表依序 intern 到 d 的字串池；d 是空的時 NameId 與檔案中相同
+  const int32_t* off = rd.ints((size_t)h[H_STRINGS] + 1);
+  std::string_view blob = rd.bytes(h[H_STRING_BYTES]);
+  rd.align4(data.data());
+  std::vector<NameId> ids(h[H_STRINGS]);
+  d.names.reserve(d.names.size() + h[H_STRINGS]);
+  for (int32_t i = 0; i < h[H_STRINGS]; ++i) {
+    if (off[i] < 0 || off[i] > off[i + 1] || off[i + 1] > h[H_STRING_BYTES])
+      throw std::runtime_error("Corrupt snapshot: " + path);
+    ids[i] = d.intern(blob.substr(off[i], off[i + 1] - off[i]));
+  }
+  auto S = [&](int32_t id) {
+    if (id < 0 || id >= (int32_t)ids.size()) throw std::runtime_error("Corrupt snapshot string id");
+    return ids[id];
+  };
+  auto O = [&](int32_t v) {
+    if (v < 0 || v > (int32_t)Orient::FW) throw std::runtime_error("Corrupt snapshot orient");
+    return (Orient)v;
+  };
+
+  const int32_t* sites = rd.ints((size_t)h[H_SITES] * kSiteFields);
+  const int32_t* macros = rd.ints((size_t)h[H_MACROS] * kMacroFields);
+  const int32_t* rows = rd.ints((size_t)h[H_ROWS] * kRowFields);
+  const int32_t* insts = rd.ints((size_t)h[H_INSTS] * kInstFields);
+  const int32_t* nets = rd.ints((size_t)h[H_NETS] * kNetFields);
+  const int32_t* refs = rd.ints((size_t)h[H_NET_REFS]);
+  const int32_t* pins = rd.ints((size_t)h[H_PINS] * kPinFields);
+  std::string_view head = rd.bytes(h[H_HEAD_BYTES]);
+  std::string_view tail = rd.bytes(h[H_TAIL_BYTES]);
+  std::string_view comps = rd.bytes(h[H_COMP_BYTES]);
+
+  d.units.lef_dbu_per_um = h[H_LEF_DBU];
+  d.units.def_dbu_per_um = h[H_DEF_DBU];
+  d.setDieArea(h[H_DIE_LLX], h[H_DIE_LLY], h[H_DIE_URX], h[H_DIE_URY]);
+
+  for (int32_t i = 0; i < h[H_SITES]; ++i) {
+    const int32_t* f = sites + (size_t)i * kSiteFields;
+    d.upsertSite(Site{S(f[0]), f[1], f[2]});
+  }
+  for (int32_t i = 0; i < h[H_MACROS]; ++i) {
+    const int32_t* f = macros + (size_t)i * kMacroFields;
+    Macro m;
+    m.name = S(f[0]);
+    m.site = S(f[1]);
+    m.w_dbu = f[2];
+    m.h_dbu = f[3];
+    m.sym_x = f[4] & 1;
+    m.sym_y = f[4] & 2;
+    m.sym_r90 = f[4] & 4;
+    d.upsertMacro(m);
+  }
+  d.rows.reserve(d.rows.size() + h[H_ROWS]);
+  for (int32_t i = 0; i < h[H_ROWS]; ++i) {
+    const int32_t* f = rows + (size_t)i * kRowFields;
+    Row r;
+    r.name = S(f[0]);
+    r.site = S(f[1]);
+    r.orient = O(f[2]);
+    r.x0 = f[3]; r.y0 = f[4];
+    r.nx = f[5]; r.ny = f[6];
+    r.step_x = f[7]; r.step_y = f[8];
+    d.addRow(r);
+  }
+  d.instances.reserve(d.instances.size() + h[H_INSTS]);
+  for (int32_t i = 0; i < h[H_INSTS]; ++i) {
+    const int32_t* f = insts + (size_t)i * kInstFields;
+    Instance inst;
+    inst.name = S(f[0]);
+    inst.macro = S(f[1]);
+    inst.orient = O(f[2]);
+    inst.x = f[3];
+    inst.y = f[4];
+    inst.fixed = f[5] != 0;
+    inst.def_order = f[6];
+    d.upsertInstance(std::move(inst));
+  }
+  d.nets.reserve(d.nets.size() + h[H_NETS]);
+  size_t r = 0;
+  for (int32_t i = 0; i < h[H_NETS]; ++i) {
+    const int32_t* f = nets + (size_t)i * kNetFields;
+    if (f[1] < 0 || f[2] < 0 || r + f[1] + f[2] > (size_t)h[H_NET_REFS])
+      throw std::runtime_error("Corrupt snapshot: " + path);
+    Net net;
+    net.name = S(f[0]);
+    net.insts.reserve(f[1]);
+    net.pins.reserve(f[2]);
+    for (int32_t k = 0; k < f[1]; ++k) net.insts.push_back(S(refs[r++]));
+    for (int32_t k = 0; k < f[2]; ++k) net.pins.push_back(S(refs[r++]));
+    d.upsertNet(std::move(net));
+  }
+  d.pins.reserve(d.pins.size() + h[H_PINS]);
+  for (int32_t i = 0; i < h[H_PINS]; ++i) {
+    const int32_t* f = pins + (size_t)i * kPinFields;
+    Pin p;
+    p.name = S(f[0]);
+    p.net = S(f[1]);
+    p.x = f[2];
+    p.y = f[3];
+    d.upsertPin(std::move(p));
+  }
+
+  def_.present = h[H_DEF_FLAGS] & 1;
+  def_.components = h[H_DEF_FLAGS] & 2;
+  def_.head = head;
+  def_.tail = tail;
+  def_.comps = comps;
+}
+
+} // namespace io
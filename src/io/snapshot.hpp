@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include "../core/design.hpp"
+#include "def_reader.hpp"
+#include "mapped_file.hpp"
+
+namespace io {
+
+// core::Design 的二進位快照。
+// 所有字串去重後放進一個字串表，其餘都是固定長度的 int32 紀錄
+// (site / macro / row / instance / net / pin)，讀檔時 mmap 後依序掃過，
+// 不需要斷詞或解析數字。DEF 的原始位元組 (含原本的 COMPONENTS 區段) 也一併存下，
+// 載入快照後不必再讀 DEF 就能輸出結果。
+// 格式與機器的 endianness 相同，只供同一台機器上重複實驗 / 中途存檔使用。
+class Snapshot {
+public:
+  // def.present 為 false 時不存 DEF 原文 (之後無法直接輸出 DEF)
+  static void save(const std::string& path, const core::Design& d, const DefText& def = {});
+
+  // 失敗 (檔案不存在、格式不符、內容截斷) 丟 std::runtime_error
+  void load(const std::string& path, core::Design& d);
+
+  // load() 之後可用：存檔時的 DEF 原文 (指向 mmap)，可直接交給 DefWriter
+  const DefText& defText() const noexcept { return def_; }
+
+private:
+  MappedFile file_;
+  DefText def_;
+};
+
+} // namespace io
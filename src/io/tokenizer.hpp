@@ -0,0 +1,123 @@
+#pragma once
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+inline bool is_space(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// 以 from_chars 解析整數，失敗時回傳 false
+inline bool parse_int(std::string_view s, int& out) noexcept {
+  if (!s.empty() && s.front() == '+') s.remove_prefix(1);
+  auto r = std::from_chars(s.data(), s.data() + s.size(), out);
+  return r.ec == std::errc() && r.ptr == s.data() + s.size();
+}
+
+// LEF/DEF 的空白分隔 tokenizer，直接在 mmap 的 buffer 上走，
+// 回傳的 string_view 指向原始檔案內容，不做任何配置。
+//  - "..." 整段當成一個 token
+//  - '#' 開頭到行尾是註解
+//  - 黏在 token 尾巴的 ';' 會被拆成獨立的 ";" token
+class Tokenizer {
+public:
+  Tokenizer(const char* begin, const char* end) : p_(begin), begin_(begin), end_(end) {}
+  explicit Tokenizer(std::string_view s) : Tokenizer(s.data(), s.data() + s.size()) {}
+
+  bool eof() {
+    skipSpace();
+    return p_ >= end_;
+  }
+
+  // 下一個 token；到檔尾回傳空 view
+  std::string_view next() {
+    skipSpace();
+    if (p_ >= end_) return {};
+
+    const char* s = p_;
+    if (*p_ == '"') {
+      const char* q = static_cast<const char*>(std::memchr(p_ + 1, '"', end_ - p_ - 1));
+      p_ = q ? q + 1 : end_;
+      return {s, size_t(p_ - s)};
+    }
+
+    while (p_ < end_ && !is_space(*p_)) ++p_;
+    if (p_ - s > 1 && p_[-1] == ';') --p_;  // "N;" -> "N" ";"
+    return {s, size_t(p_ - s)};
+  }
+
+  std::string_view peek() {
+    const char* save = p_;
+    std::string_view t = next();
+    p_ = save;
+    return t;
+  }
+
+  // 下一個 token 必須是整數
+  int nextInt() {
+    std::string_view t = next();
+    int v = 0;
+    if (!parse_int(t, v))
+      throw std::runtime_error("Expected integer, got '" + std::string(t) + "'");
+    return v;
+  }
+
+  // 消耗 token 直到 (含) ";"
+  void skipStatement() {
+    for (std::string_view t = next(); !t.empty() && t != ";"; t = next()) {}
+  }
+
+  // 從目前位置往後找 "END <name>"，回傳 "END" 的位置 (找不到回傳 buffer 結尾)；
+  // 直接在 buffer 上找，不逐一切 token，也不移動讀取位置
+  const char* findEnd(std::string_view name) const {
+    std::string_view rest(p_, end_ - p_);
+    for (size_t pos = rest.find("END"); pos != std::string_view::npos;
+         pos = rest.find("END", pos + 3)) {
+      bool at_start = pos == 0 || is_space(rest[pos - 1]);
+      Tokenizer t(rest.data() + pos + 3, end_);
+      if (at_start && pos + 3 < rest.size() && is_space(rest[pos + 3]) && t.next() == name)
+        return rest.data() + pos;
+    }
+    return end_;
+  }
+
+  // 跳過整個 section (含 "END <name>")
+  void skipSection(std::string_view name) {
+    p_ = findEnd(name);
+    if (p_ < end_) {
+      next();  // END
+      next();  // <name>
+    }
+  }
+
+  // 讀取位置移到 p (必須在同一個 buffer 內)
+  void seek(const char* p) noexcept { p_ = p; }
+
+  // 目前讀取位置在整個 buffer 中的位移
+  size_t offset() const noexcept { return size_t(p_ - begin_); }
+  const char* pos() const noexcept { return p_; }
+
+private:
+  void skipSpace() {
+    while (p_ < end_) {
+      if (is_space(*p_)) {
+        ++p_;
+      } else if (*p_ == '#') {
+        const char* nl = static_cast<const char*>(std::memchr(p_, '\n', end_ - p_));
+        p_ = nl ? nl + 1 : end_;
+      } else {
+        break;
+      }
+    }
+  }
+
+  const char* p_;
+  const char* begin_;
+  const char* end_;
+};
+
+} // namespace io
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 namespace io {
@@ -11,4 +13,44 @@ inline std::string trim(const std::string& s) {
     return s.substr(start, end - start + 1);
 }
 
+// 64-bit 內容 hash (每次吃 8 bytes 的 multiply-xorshift)，用於快取 key，非密碼學用途
+inline uint64_t hash_bytes(const char* p, size_t n) {
+    const uint64_t m = 0x9E3779B97F4A7C15ull;
+    uint64_t h = 0xCBF29CE484222325ull ^ (n * m);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * m;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, p + i, n - i);
+    h = (h ^ tail) * m;
+    return h ^ (h >> 32);
+}
+
+// 與 hash_bytes 不同的常數與混合方式 (由尾端往前吃)，當快取內容的第二個檢查碼：
+// hash_bytes 已經是檔名，兩者要同時碰撞才會誤用快取
+inline uint64_t digest_bytes(const char* p, size_t n) {
+    const uint64_t c1 = 0x87C37B91114253D5ull, c2 = 0x4CF5AD432745937Full;
+    uint64_t h = 0x52DCE729DA3ED5A1ull + n;
+    size_t i = n;
+    for (; i >= 8; i -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p + i - 8, 8);
+        w *= c1;
+        w = (w << 31) | (w >> 33);
+        h ^= w * c2;
+        h = ((h << 27) | (h >> 37)) * 5 + 0x52DCE729ull;
+    }
+    uint64_t head = 0;
+    std::memcpy(&head, p, i);
+    h ^= head * c1;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
 }  // namespace io
@@ -1,32 +1,217 @@
 #include<bits/stdc++.h>
 #include "core/design.hpp"
 #include "core/hpwl.hpp"
+#include "core/hpwl_simd.hpp"
+#include "core/hpwl_parallel.hpp"
+#include "core/thread_pool.hpp"
+#include "core/netlist.hpp"
+#include "core/profiler.hpp"
 #include "io/lef_reader.hpp"
 #include "io/def_reader.hpp"
 #include "placer/detailed_placer.hpp"
+#include "placer/window_driver.hpp"
+#include "placer/row_index.hpp"
+#include "placer/global_swap.hpp"
+#include "placer/row_reorder.hpp"
+#include "placer/anytime_optimizer.hpp"
+#include "placer/annealer.hpp"
 #include "io/def_writer.hpp"
+#include "io/snapshot.hpp"
 
 using namespace std;
 
 int main(int argc, char* argv[]){
-  
-  if (argc < 4) {
-    cerr << "Usage: " << argv[0] << " <input LEF> <input DEF> <output DEF>\n";
+  const auto start = chrono::steady_clock::now();
+
+  vector<string> args;
+  string lef_cache, save_snapshot, load_snapshot, checkpoint, profile;
+  int threads = 0, worst_nets = 0;
+  double time_limit = 0;
+  WindowOptions wopt;
+  GlobalSwapOptions gopt;
+  ReorderOptions ropt;
+  AnnealOptions sa;
+  bool anneal = false;
+  DetailedPlacer::MatchSolver solver = DetailedPlacer::MatchSolver::LAP;
+  int candidates = 0;
+  bool bad_args = false;
+  for (int i = 1; i < argc; ++i) {
+    string a = argv[i];
+    // 數值參數不合法時 stoi / stod 丟 invalid_argument / out_of_range
+    try {
+      if (a == "--lef-cache" && i + 1 < argc) lef_cache = argv[++i];
+      else if (a == "--threads" && i + 1 < argc) threads = stoi(argv[++i]);
+      else if (a == "--worst-nets" && i + 1 < argc) worst_nets = stoi(argv[++i]);
+      else if (a == "--window" && i + 1 < argc) wopt.window_sites = stoi(argv[++i]);
+      else if (a == "--window-rows" && i + 1 < argc) wopt.window_rows = stoi(argv[++i]);
+      else if (a == "--passes" && i + 1 < argc) wopt.passes = stoi(argv[++i]);
+      else if (a == "--tol" && i + 1 < argc) wopt.tolerance = stod(argv[++i]);
+      else if (a == "--global-swap" && i + 1 < argc) gopt.passes = stoi(argv[++i]);
+      else if (a == "--reorder" && i + 1 < argc) ropt.window = stoi(argv[++i]);
+      else if (a == "--no-shift") wopt.shift = false;
+      else if (a == "--no-warm-start") wopt.warm_start = false;
+      else if (a == "--anneal" && i + 1 < argc) { sa.epochs = stoi(argv[++i]); anneal = sa.epochs > 0; }
+      else if (a == "--anneal-seconds" && i + 1 < argc) { sa.seconds = stod(argv[++i]); anneal = sa.seconds > 0; }
+      else if (a == "--anneal-seed" && i + 1 < argc) sa.seed = stoull(argv[++i]);
+      else if (a == "--anneal-t0" && i + 1 < argc) sa.t0_scale = stod(argv[++i]);
+      else if (a == "--save-snapshot" && i + 1 < argc) save_snapshot = argv[++i];
+      else if (a == "--load-snapshot" && i + 1 < argc) load_snapshot = argv[++i];
+      else if (a == "--checkpoint" && i + 1 < argc) checkpoint = argv[++i];
+      else if (a == "--time-limit" && i + 1 < argc) time_limit = stod(argv[++i]);
+      else if (a == "--profile" && i + 1 < argc) profile = argv[++i];
+      else if (a == "--candidates" && i + 1 < argc) candidates = stoi(argv[++i]);
+      else if (a == "--solver" && i + 1 < argc) {
+        string v = argv[++i];
+        if (v == "lap") solver = DetailedPlacer::MatchSolver::LAP;
+        else if (v == "mcmf") solver = DetailedPlacer::MatchSolver::MCMF;
+        else { cerr << "Unknown solver: " << v << "\n"; bad_args = true; break; }
+      }
+      else args.push_back(a);
+    } catch (const logic_error&) {
+      cerr << "Invalid value for " << a << ": " << argv[i] << "\n";
+      bad_args = true;
+      break;
+    }
+  }
+
+  // 從快照載入時不需要 LEF / DEF，只剩輸出檔
+  if (bad_args || args.size() < (load_snapshot.empty() ? 3u : 1u)) {
+    cerr << "Usage: " << argv[0] << " <input LEF> <input DEF> <output DEF> [options]\n"
+         << "       " << argv[0] << " --load-snapshot <file> <output DEF> [options]\n"
+         << "  --lef-cache <dir>   cache parsed LEF keyed by file hash\n"
+         << "  --threads <n>       worker threads (default: all cores)\n"
+         << "  --worst-nets <n>    print the n nets with the largest HPWL\n"
+         << "  --window <sites>    window width in sites (default " << wopt.window_sites << ")\n"
+         << "  --window-rows <n>   window height in rows (default " << wopt.window_rows << ")\n"
+         << "  --passes <n>        max window passes (default " << wopt.passes << ")\n"
+         << "  --tol <ratio>       stop when a pass gains less than ratio * HPWL (default " << wopt.tolerance << ")\n"
+         << "  --global-swap <n>   global swap passes before windowing, 0 disables (default " << gopt.passes << ")\n"
+         << "  --reorder <k>       in-row reordering window in cells, 0 disables (default " << ropt.window << ")\n"
+         << "  --no-shift          skip row-segment shifting after each window pass\n"
+         << "  --no-warm-start     solve every window assignment from scratch instead of\n"
+         << "                      starting from the current placement\n"
+         << "  --anneal <epochs>   parallel simulated-annealing refinement after reordering\n"
+         << "                      (default off; not used with --time-limit)\n"
+         << "  --anneal-seconds <s> annealing time budget; the cooling follows elapsed time, so\n"
+         << "                      results differ between runs and --threads settings (only a\n"
+         << "                      fixed --anneal <epochs> is reproducible)\n"
+         << "  --anneal-t0 <scale> start temperature as a fraction of the median uphill delta,\n"
+         << "                      0 accepts only non-worsening moves (default " << sa.t0_scale << ")\n"
+         << "  --anneal-seed <n>   random seed for annealing (default " << sa.seed << ")\n"
+         << "  --solver lap|mcmf   region assignment solver (default lap)\n"
+         << "  --candidates <k>    keep only the k best nearby sites per cell and solve the\n"
+         << "                      sparse matching; 0 uses the full cost matrix (default 0)\n"
+         << "  --save-snapshot <f> save the parsed design as a binary snapshot\n"
+         << "  --load-snapshot <f> read the design from a snapshot instead of LEF/DEF\n"
+         << "  --checkpoint <f>    save the placed design as a snapshot before writing DEF\n"
+         << "  --time-limit <sec>  wall-clock budget for the whole run; passes are scheduled\n"
+         << "                      by measured gain per second and stop in time to write DEF\n"
+         << "  --profile <file>    write phase timers and solver counters as JSON\n"
+         << "                      (needs a build with make PROFILE=1)\n";
     return 1;
   }
 
+  core::ThreadPool pool(threads);
+
   core::Design d;
   io::LefReader lef;
   io::DefReader def;
+  io::Snapshot snap;
+  lef.cache_dir = lef_cache;
+  def.pool = &pool;
 
-  lef.read(argv[1], d);
-  def.read(argv[2], d);
+  if (!load_snapshot.empty()) {
+    snap.load(load_snapshot, d);
+  } else {
+    lef.read(args[0], d);
+    def.read(args[1], d);
+  }
   d.buildInstanceNetLists();
+  const double load_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  const io::DefText def_text = load_snapshot.empty() ? def.text() : snap.defText();
+  const string out_def = args.back();
 
-  
+  if (!save_snapshot.empty()) io::Snapshot::save(save_snapshot, d, def_text);
+
+  core::Netlist nl;
+  nl.build(d);
 
-//   io::DefWriter writer;
-//   writer.write(argv[2] /*input DEF*/, d, argv[3] /*output DEF*/);
+  DetailedPlacer dp(d, nl);
+  dp.solver = solver;
+  dp.candidates = candidates;
+
+  if (time_limit > 0) {
+    PDA_PROF_SCOPE("optimize");
+    // 寫 DEF 的時間以讀檔時間估計 (輸出只重新格式化 COMPONENTS，其餘直接拼接)，
+    // 另存 checkpoint 時再多留一些
+    double reserve = 0.05 + load_seconds * (checkpoint.empty() ? 1.0 : 1.5);
+    AnytimeOptions aopt;
+    aopt.deadline = core::Deadline::after(time_limit, start).earlier(reserve);
+    aopt.window = wopt;
+    aopt.swap = gopt;
+    aopt.reorder = ropt;
+    aopt.shift = wopt.shift;
+    aopt.tolerance = wopt.tolerance;
+    AnytimeOptimizer anytime(d, nl, dp, pool);
+    AnytimeOptimizer::Stats st = anytime.run(aopt);
+    cout << "anytime hpwl " << st.final << " gain " << st.initial - st.final << " (" << st.steps << " steps, "
+         << (st.timed_out ? "time limit" : "converged") << (st.restored ? ", restored best" : "") << ")\n";
+    if (st.violations) {
+      cerr << "[WARN] " << st.violations << " instances are overlapping or off the site grid\n";
+    }
+  } else {
+    PDA_PROF_SCOPE("optimize");
+    // AnytimeOptimizer 自己維護索引，只有固定流程需要
+    RowIndex row_index;
+    if (gopt.passes > 0) {
+      row_index.build(d, nl);
+      IncrementalHpwl inc(nl);
+      GlobalSwap gs(nl, row_index, inc);
+      GlobalSwap::Stats st = gs.run(gopt);
+      cout << "global swap hpwl " << inc.total() << " gain " << st.gain
+           << " (" << st.swaps << " swaps, " << st.moves << " moves)\n";
+    }
+
+    WindowDriver driver(d, nl, dp, pool);
+    driver.run(wopt);
+
+    // 視窗階段沒有維護索引，重建後再做 row 內重排
+    row_index.build(d, nl);
+    if (ropt.window > 1) {
+      RowReorder reorder(nl, row_index, pool);
+      RowReorder::Stats st = reorder.run(ropt);
+      cout << "reorder hpwl " << core::hpwl_counts_parallel(nl, pool) << " gain " << st.gain
+           << " (" << st.improved << "/" << st.windows << " windows)\n";
+      row_index.build(d, nl);
+    }
+    if (anneal) {
+      // 時間預算同時是截止點：到期時正在跑的 tile 也會停下，不會多跑一個 epoch
+      if (sa.seconds > 0) sa.deadline = core::Deadline::after(sa.seconds);
+      Annealer annealer(nl, row_index, pool);
+      Annealer::Stats st = annealer.run(sa);
+      cout << "anneal hpwl " << st.final << " gain " << st.initial - st.final << " (" << st.epochs << " epochs, "
+           << st.accepted << "/" << st.proposals << " accepted, " << st.uphill << " uphill"
+           << (st.restored ? ", restored best" : "") << ")\n";
+    }
+    if (wopt.shift) {
+      RowShift shifter(nl);
+      RowShift::Stats st = shifter.run(row_index);
+      cout << "shift gain " << st.gain << " (" << st.improved << "/" << st.segments << " segments)\n";
+      row_index.build(d, nl);
+    }
+    if (int bad = row_index.violations()) {
+      cerr << "[WARN] " << bad << " instances are overlapping or off the site grid\n";
+    }
+  }
+
+  nl.writeBack(d);
+  if (!checkpoint.empty()) io::Snapshot::save(checkpoint, d, def_text);
+  io::DefWriter writer;
+  writer.write(def_text /*input DEF (mmap)*/, d, out_def);
+  if (time_limit > 0) {
+    cout << "wall time " << chrono::duration<double>(chrono::steady_clock::now() - start).count()
+         << " s (limit " << time_limit << " s)\n";
+  }
 
   // cout << "lef DBU " << d.units.lef_dbu_per_um << '\n';
   
@@ -115,6 +300,17 @@ int main(int argc, char* argv[]){
 
   // cout << "---------- Pins ----------\n";
 
-  cout << "hpwl " << core::hpwl_counts(d) << '\n';
+  core::HpwlReport report = core::hpwl_report(nl, pool, worst_nets);
+  cout << "hpwl " << report.total << '\n';
+  for (int n : report.worst) {
+    cout << "  " << nl.net_names[n] << " hpwl " << report.per_net[n]
+         << " degree " << nl.netDegree(n) << '\n';
+  }
 
+  if (!profile.empty()) {
+    if (!core::prof::enabled()) {
+      cerr << "[WARN] built without PDA_PROFILE (make PROFILE=1); " << profile << " has no data\n";
+    }
+    core::prof::write_json(profile);
+  }
 }
\ No newline at end of file
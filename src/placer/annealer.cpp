@@ -0,0 +1,399 @@
+#include "annealer.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+Annealer::Annealer(core::Netlist& nl, RowIndex& index, core::ThreadPool& pool)
+    : netlist(nl), index(index), pool(pool) {
+    workspaces.resize(pool.size());
+    for (auto& ws : workspaces) {
+        ws.own_stamp.assign(nl.numNodes(), 0);
+        ws.net_local.assign(nl.num_nets, 0);
+        ws.net_stamp.assign(nl.num_nets, 0);
+    }
+}
+
+long long Annealer::sync() {
+    const int nn = netlist.num_nets;
+    const int grain = 4096;
+    boxes.resize(nn);
+    vector<long long> sums(core::ThreadPool::num_chunks(nn, grain), 0);
+    pool.parallel_for(nn, grain, [&](int b, int e, int) {
+        long long s = 0;
+        for (int n = b; n < e; ++n) {
+            Box box;
+            for (int k = netlist.netBegin(n); k < netlist.netEnd(n); ++k) {
+                int node = netlist.net_pins[k];
+                box.add(netlist.x[node], netlist.y[node]);
+            }
+            boxes[n] = box;
+            s += box.hpwl();
+        }
+        sums[b / grain] = s;
+    });
+
+    snap_x.assign(netlist.x.begin(), netlist.x.begin() + netlist.numNodes());
+    snap_y.assign(netlist.y.begin(), netlist.y.begin() + netlist.numNodes());
+
+    long long total = 0;
+    for (long long s : sums) total += s;
+    return total;
+}
+
+void Annealer::buildTiles(const AnnealOptions& opt, int row_off, int col_off) {
+    tiles.clear();
+    const int R = index.numRows();
+    if (R == 0) return;
+    int gx0 = index.row(0).x0, gx1 = index.row(0).x1;
+    for (int r = 0; r < R; ++r) {
+        gx0 = min(gx0, index.row(r).x0);
+        gx1 = max(gx1, index.row(r).x1);
+    }
+    const int TR = max(1, opt.tile_rows);
+    const int step = index.row(0).step;
+    const int TW = max(1, opt.tile_sites) * step;
+    for (int b = -row_off; b < R; b += TR) {
+        const int r0 = max(0, b), r1 = min(R - 1, b + TR - 1);
+        if (r0 > r1) continue;
+        for (int xl = gx0 - col_off * step; xl < gx1; xl += TW) tiles.push_back({r0, r1, xl, xl + TW});
+    }
+}
+
+void Annealer::markSites(Workspace& ws, int tr, int site, int count, int value) {
+    int* p = ws.occ.data() + ws.row_off[tr];
+    for (int s = max(0, site); s < min(ws.row_sites[tr], site + count); ++s) p[s] = value;
+}
+
+bool Annealer::setupTile(Workspace& ws, const Tile& t) {
+    ++ws.stamp;
+    ws.cells.clear();
+    ws.cell_row.clear();
+    ws.cell_site.clear();
+
+    // 1. tile 內各 row 的 site 範圍
+    const int nrows = t.r1 - t.r0 + 1;
+    ws.row_first.resize(nrows);
+    ws.row_sites.resize(nrows);
+    ws.row_off.resize(nrows);
+    int total = 0;
+    for (int tr = 0; tr < nrows; ++tr) {
+        const RowIndex::Row& row = index.row(t.r0 + tr);
+        const int lo = max(t.xl, row.x0), hi = min(t.xr, row.x1);
+        const int first = lo <= row.x0 ? 0 : (lo - row.x0 + row.step - 1) / row.step;
+        const int last = hi <= row.x0 ? 0 : (hi - row.x0) / row.step;
+        ws.row_first[tr] = first;
+        ws.row_sites[tr] = max(0, last - first);
+        ws.row_off[tr] = total;
+        total += ws.row_sites[tr];
+    }
+    ws.occ.assign(total, -1);
+
+    // 2. site 格點以 row 的第一段為準；不在任何 ROW segment 內、或所在的段格點不同的
+    //    site 當成障礙物
+    for (int tr = 0; tr < nrows; ++tr) {
+        const int r = t.r0 + tr;
+        const RowIndex::Row& row = index.row(r);
+        for (int s = 0; s < ws.row_sites[tr]; ++s) {
+            const int x = row.x0 + (ws.row_first[tr] + s) * row.step;
+            const int sg = index.segmentAt(r, x);
+            if (sg < 0 || row.segs[sg].step != row.step || !index.onGrid(r, x, row.step))
+                ws.occ[ws.row_off[tr] + s] = -2;
+        }
+    }
+
+    // 3. 單元：完全在 tile 內、對齊 site 的單一 row 高可動單元歸 tile 所有，其餘是障礙物。
+    //    這裡碰到的單元在 epoch 中只有 tile 自己會動，snap 與目前座標相同
+    for (int tr = 0; tr < nrows; ++tr) {
+        if (ws.row_sites[tr] == 0) continue;
+        const int r = t.r0 + tr;
+        const RowIndex::Row& row = index.row(r);
+        const int xl = row.x0 + ws.row_first[tr] * row.step;
+        const int xr = xl + ws.row_sites[tr] * row.step;
+        ws.found.clear();
+        index.cellsIn(r, r, xl, xr, ws.found);
+        for (int c : ws.found) {
+            const int x = snap_x[c], w = netlist.width[c];
+            const int sg = index.segmentAt(r, x);
+            const bool mine = !netlist.fixed[c] && w > 0 && w % row.step == 0 && netlist.height[c] <= row.height &&
+                              snap_y[c] == row.y && (x - row.x0) % row.step == 0 && x >= xl && x + w <= xr &&
+                              sg >= 0 && row.segs[sg].step == row.step && index.onGrid(r, x, w);
+            if (mine) {
+                const int l = (int)ws.cells.size();
+                ws.cells.push_back(c);
+                ws.own_stamp[c] = ws.stamp;
+                ws.cell_row.push_back(tr);
+                ws.cell_site.push_back((x - xl) / row.step);
+                markSites(ws, tr, ws.cell_site.back(), w / row.step, l);
+            } else {
+                const int s0 = (int)floor((double)(x - xl) / row.step);
+                const int s1 = (int)ceil((double)(x + w - xl) / row.step);
+                markSites(ws, tr, s0, s1 - s0, -2);
+            }
+        }
+    }
+    if (ws.cells.empty()) return false;
+
+    // 4. 局部 net 與兩個方向的 CSR
+    const int nc = (int)ws.cells.size();
+    ws.nets.clear();
+    ws.cell_net_start.assign(1, 0);
+    ws.cell_nets.clear();
+    for (int l = 0; l < nc; ++l) {
+        const int c = ws.cells[l];
+        for (int k = netlist.instBegin(c); k < netlist.instEnd(c); ++k) {
+            const int n = netlist.inst_nets[k];
+            if (ws.net_stamp[n] != ws.stamp) {
+                ws.net_stamp[n] = ws.stamp;
+                ws.net_local[n] = (int)ws.nets.size();
+                ws.nets.push_back(n);
+            }
+            ws.cell_nets.push_back(ws.net_local[n]);
+        }
+        ws.cell_net_start.push_back((int)ws.cell_nets.size());
+    }
+    const int L = (int)ws.nets.size();
+    ws.net_pin_start.assign(L + 1, 0);
+    for (int ln : ws.cell_nets) ++ws.net_pin_start[ln + 1];
+    for (int ln = 0; ln < L; ++ln) ws.net_pin_start[ln + 1] += ws.net_pin_start[ln];
+    ws.net_pins.resize(ws.cell_nets.size());
+    vector<int>& fill_pos = ws.found; // 借用
+    fill_pos.assign(ws.net_pin_start.begin(), ws.net_pin_start.end() - 1);
+    for (int l = 0; l < nc; ++l) {
+        for (int q = ws.cell_net_start[l]; q < ws.cell_net_start[l + 1]; ++q) ws.net_pins[fill_pos[ws.cell_nets[q]]++] = l;
+    }
+
+    // 5. tile 外的 box：同步的 box 每條邊界上都還有 tile 外的 pin 時就是它，否則重掃
+    ws.ext.resize(L);
+    ws.cur.resize(L);
+    for (int ln = 0; ln < L; ++ln) {
+        const int n = ws.nets[ln];
+        const Box& g = boxes[n];
+        int on_xmin = 0, on_xmax = 0, on_ymin = 0, on_ymax = 0;
+        for (int p = ws.net_pin_start[ln]; p < ws.net_pin_start[ln + 1]; ++p) {
+            const int c = ws.cells[ws.net_pins[p]];
+            on_xmin += snap_x[c] == g.xmin;
+            on_xmax += snap_x[c] == g.xmax;
+            on_ymin += snap_y[c] == g.ymin;
+            on_ymax += snap_y[c] == g.ymax;
+        }
+        if (on_xmin < g.nxmin && on_xmax < g.nxmax && on_ymin < g.nymin && on_ymax < g.nymax) {
+            ws.ext[ln] = g;
+        } else {
+            Box e;
+            for (int k = netlist.netBegin(n); k < netlist.netEnd(n); ++k) {
+                const int node = netlist.net_pins[k];
+                if (ws.own_stamp[node] != ws.stamp) e.add(snap_x[node], snap_y[node]);
+            }
+            ws.ext[ln] = e;
+        }
+        ws.cur[ln] = g.hpwl(); // tile 內的單元還在 snap 的位置，整條 net 就是同步的 box
+    }
+    ws.eval_stamp.assign(L, 0);
+    ws.eval = 0;
+    return true;
+}
+
+long long Annealer::trialDelta(Workspace& ws, int a, int ax, int ay, int b, int bx, int by) {
+    ++ws.eval;
+    ws.trial.clear();
+    long long delta = 0;
+    auto visit = [&](int l) {
+        for (int q = ws.cell_net_start[l]; q < ws.cell_net_start[l + 1]; ++q) {
+            const int ln = ws.cell_nets[q];
+            if (ws.eval_stamp[ln] == ws.eval) continue;
+            ws.eval_stamp[ln] = ws.eval;
+            Box box = ws.ext[ln];
+            for (int p = ws.net_pin_start[ln]; p < ws.net_pin_start[ln + 1]; ++p) {
+                const int o = ws.net_pins[p];
+                if (o == a) box.add(ax, ay);
+                else if (o == b) box.add(bx, by);
+                else box.add(netlist.x[ws.cells[o]], netlist.y[ws.cells[o]]);
+            }
+            const long long h = box.hpwl();
+            ws.trial.push_back({ln, h});
+            delta += h - ws.cur[ln];
+        }
+    };
+    visit(a);
+    if (b >= 0) visit(b);
+    return delta;
+}
+
+void Annealer::annealTile(Workspace& ws, const Tile& t, double temperature, int moves_per_cell,
+                          const core::Deadline& deadline, TileStats& st) {
+    const int nc = (int)ws.cells.size();
+    const int total = (int)ws.occ.size();
+    if (total == 0) return;
+    const int nrows = (int)ws.row_off.size();
+    const long long moves = (long long)nc * max(1, moves_per_cell);
+
+    for (long long it = 0; it < moves; ++it) {
+        if ((it & 255) == 0 && deadline.expired()) break;
+        // 隨機的單元與 tile 內隨機的 site
+        const int a = int(ws.rng() % nc);
+        const int f = int(ws.rng() % total);
+        int tr = nrows - 1;
+        while (ws.row_off[tr] > f) --tr;
+        const int s = f - ws.row_off[tr];
+        const RowIndex::Row& row = index.row(t.r0 + tr);
+        const RowIndex::Row& arow = index.row(t.r0 + ws.cell_row[a]);
+        const int ca = ws.cells[a], w = netlist.width[ca];
+        if (netlist.height[ca] > row.height || w % row.step != 0) continue;
+        const int cnt = w / row.step;
+
+        int b = -1, ax = 0, ay = row.y, bx = 0, by = 0;
+        const int o = ws.occ[f];
+        if (o >= 0) {
+            // 同寬度的單元：交換
+            if (o == a) continue;
+            const int cb = ws.cells[o];
+            if (netlist.width[cb] != w || netlist.height[cb] > arow.height) continue;
+            b = o;
+            ax = netlist.x[cb]; ay = netlist.y[cb];
+            bx = netlist.x[ca]; by = netlist.y[ca];
+        } else if (o == -1) {
+            // 空位：左緣對齊 site s，整段都要是空的 (或是自己)
+            if (s + cnt > ws.row_sites[tr]) continue;
+            const int* p = ws.occ.data() + f;
+            bool fits = true;
+            for (int q = 0; q < cnt && fits; ++q) fits = (p[q] == -1 || p[q] == a);
+            if (!fits) continue;
+            ax = row.x0 + (ws.row_first[tr] + s) * row.step;
+            if (ax == netlist.x[ca] && ay == netlist.y[ca]) continue;
+        } else {
+            continue; // 障礙物
+        }
+
+        ++st.proposals;
+        const long long d = trialDelta(ws, a, ax, ay, b, bx, by);
+        bool accept = d <= 0;
+        if (d > 0) {
+            ++st.up_bins[63 - __builtin_clzll((unsigned long long)d)];
+            const double u = (ws.rng() >> 11) * 0x1.0p-53;
+            accept = temperature > 0 && u < exp(-(double)d / temperature);
+        }
+        if (!accept) continue;
+        ++st.accepted;
+        if (d > 0) ++st.uphill;
+
+        for (const auto& [ln, h] : ws.trial) ws.cur[ln] = h;
+        const int ra = ws.cell_row[a], sa = ws.cell_site[a];
+        const int a_cnt = w / arow.step;
+        if (b < 0) {
+            markSites(ws, ra, sa, a_cnt, -1);
+            markSites(ws, tr, s, cnt, a);
+            ws.cell_row[a] = tr;
+            ws.cell_site[a] = s;
+        } else {
+            const int rb = ws.cell_row[b], sb = ws.cell_site[b];
+            markSites(ws, rb, sb, cnt, a);
+            markSites(ws, ra, sa, a_cnt, b);
+            swap(ws.cell_row[a], ws.cell_row[b]);
+            swap(ws.cell_site[a], ws.cell_site[b]);
+            netlist.x[ws.cells[b]] = bx;
+            netlist.y[ws.cells[b]] = by;
+        }
+        netlist.x[ca] = ax;
+        netlist.y[ca] = ay;
+    }
+}
+
+// (seed, epoch, tile) -> 亂數種子 (splitmix64)
+static uint64_t tile_seed(uint64_t seed, int epoch, int tile) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * ((uint64_t)epoch << 32 | (uint32_t)tile);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+Annealer::Stats Annealer::run(const AnnealOptions& opt) {
+    PDA_PROF_SCOPE("opt.anneal");
+    using Clock = chrono::steady_clock;
+    Stats st;
+    const int n = netlist.num_insts;
+    long long hpwl = sync();
+    long long best = hpwl;
+    st.initial = hpwl;
+    vector<int> best_x(netlist.x.begin(), netlist.x.begin() + n);
+    vector<int> best_y(netlist.y.begin(), netlist.y.begin() + n);
+
+    const auto start = Clock::now();
+    double t0 = 0;
+    for (int e = 0;; ++e) {
+        const double p = opt.seconds > 0 ? chrono::duration<double>(Clock::now() - start).count() / opt.seconds
+                                         : (double)e / max(1, opt.epochs);
+        if ((e > 0 && p >= 1) || opt.deadline.expired()) break;
+        const double temperature = e == 0 ? 0.0 : t0 * pow(opt.final_ratio, min(p, 1.0));
+
+        // 奇數 epoch 偏移半個 tile
+        const bool odd = e % 2;
+        buildTiles(opt, odd ? opt.tile_rows / 2 : 0, odd ? opt.tile_sites / 2 : 0);
+        tile_stats.assign(tiles.size(), TileStats());
+        pool.parallel_for((int)tiles.size(), 1, [&](int b, int end, int tid) {
+            Workspace& ws = workspaces[tid];
+            for (int q = b; q < end; ++q) {
+                if (opt.deadline.expired()) break;
+                ws.rng.seed(tile_seed(opt.seed, e, q));
+                if (!setupTile(ws, tiles[q])) continue;
+                annealTile(ws, tiles[q], temperature, opt.moves_per_cell, opt.deadline, tile_stats[q]);
+            }
+        });
+
+        TileStats sum;
+        for (const TileStats& ts : tile_stats) {
+            sum.proposals += ts.proposals;
+            sum.accepted += ts.accepted;
+            sum.uphill += ts.uphill;
+            for (int k = 0; k < 64; ++k) sum.up_bins[k] += ts.up_bins[k];
+        }
+        st.proposals += sum.proposals;
+        st.accepted += sum.accepted;
+        st.uphill += sum.uphill;
+
+        // 索引同步 (有動的單元)，再同步 net box 與 HPWL
+        for (int i = 0; i < n; ++i) {
+            if (netlist.x[i] != snap_x[i] || netlist.y[i] != snap_y[i]) index.move(i, netlist.x[i], netlist.y[i]);
+        }
+        hpwl = sync();
+        ++st.epochs;
+        if (hpwl < best) {
+            best = hpwl;
+            copy(netlist.x.begin(), netlist.x.begin() + n, best_x.begin());
+            copy(netlist.y.begin(), netlist.y.begin() + n, best_y.begin());
+        }
+        // 變差提議 delta 的中位數 (取中位數所在桶的中點)
+        if (e == 0 && opt.t0_scale > 0) {
+            long long count = 0, seen = 0;
+            for (long long c : sum.up_bins) count += c;
+            for (int k = 0; k < 64 && count > 0; ++k) {
+                seen += sum.up_bins[k];
+                if (2 * seen < count) continue;
+                t0 = opt.t0_scale * 1.5 * ldexp(1.0, k);
+                break;
+            }
+        }
+        if (opt.verbose) {
+            cout << "anneal epoch " << e + 1 << " T " << temperature << " hpwl " << hpwl << " accepted "
+                 << sum.accepted << "/" << sum.proposals << " (uphill " << sum.uphill << ")\n";
+        }
+    }
+
+    if (hpwl > best) {
+        for (int i = 0; i < n; ++i) {
+            if (netlist.x[i] == best_x[i] && netlist.y[i] == best_y[i]) continue;
+            netlist.x[i] = best_x[i];
+            netlist.y[i] = best_y[i];
+            index.move(i, best_x[i], best_y[i]);
+        }
+        hpwl = best;
+        st.restored = true;
+    }
+    st.final = hpwl;
+    PDA_PROF_COUNT("anneal.proposals", st.proposals);
+    PDA_PROF_COUNT("anneal.accepted", st.accepted);
+    PDA_PROF_COUNT("anneal.uphill", st.uphill);
+    PDA_PROF_SAMPLE("anneal.gain", st.initial - st.final);
+    return st;
+}
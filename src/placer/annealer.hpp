@@ -0,0 +1,127 @@
+#pragma once
+#include "../core/deadline.hpp"
+#include "../core/netlist.hpp"
+#include "../core/thread_pool.hpp"
+#include "row_index.hpp"
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 平行模擬退火 (simulated annealing)
+// ==========================================
+// 視窗指派 / global swap 只接受變好的移動，容易卡在局部最小值；
+// 這裡以隨機的交換 / 移動提議，依溫度接受部分變差的結果。
+//
+// 版面切成 tile_rows x tile_sites 的 tile。一個 epoch 內各 tile 平行退火，
+// 每個 tile 只動「完全落在 tile 內」的單一 row 高可動單元，目標也只在 tile 內，
+// 所以不同 tile 的單元互不干擾；其餘單元 (FIXED、macro、跨 tile 邊界的) 當障礙物。
+//   - 提議：隨機挑一個單元與 tile 內一個 site；site 上是同寬度的單元就交換，
+//     是足夠寬的空位就移過去 (對齊 site)，其他情況放棄。結果一定合法。
+//   - delta：每條 net 拆成「tile 外的 pin」與「tile 內的 pin」，tile 外的部分在
+//     epoch 開始時由同步的 bounding box (邊界上的 pin 數) 取得，必要時才重掃；
+//     之後每次試算只看 tile 內那幾個 pin。
+//   - 每個 epoch 結束後同步所有 net 的 bounding box 並計算實際 HPWL，
+//     下一個 epoch 的 tile 偏移半個 tile，讓邊界上的單元也能移動。
+// 溫度：第一個 epoch 為 0 (只接受不變差的提議)，T0 = t0_scale * 其中變差提議
+// delta 的中位數 (0.02 時中位數的提議幾乎不會被接受，只有小的變差會過)，之後依進度
+// p (epoch 比例或時間比例) 以 T0 * final_ratio^p 幾何降溫。
+// 結束時若最後的 HPWL 不是最好的就還原成最好的狀態，不會比輸入差。
+// tile 的亂數種子只取決於 (seed, epoch, tile)，固定 epoch 數時結果與執行緒數無關；
+// 以時間為準 (seconds / deadline) 時進度與在哪個提議停下都取決於執行速度，無法重現。
+struct AnnealOptions {
+    int epochs = 40;             // 同步次數 (seconds > 0 時由時間決定進度)
+    int moves_per_cell = 10;     // 每個 epoch 每個單元的提議數
+    int tile_sites = 64;         // tile 寬度 (site 數)
+    int tile_rows = 4;           // tile 高度 (row 數)
+    double t0_scale = 0.02;      // T0 / 變差提議 delta 的中位數；0 為只接受不變差的提議
+    double final_ratio = 1e-3;   // 最後溫度 / T0
+    double seconds = 0;          // > 0 時為時間預算
+    uint64_t seed = 1;
+    bool verbose = false;        // 每個 epoch 印出溫度與 HPWL
+    core::Deadline deadline;     // 到期後不再開始新的 epoch / tile，tile 內也會停止提議
+};
+
+class Annealer {
+public:
+    struct Stats {
+        long long initial = 0, final = 0;  // HPWL
+        int epochs = 0;
+        long long proposals = 0;           // 合法的提議數
+        long long accepted = 0;
+        long long uphill = 0;              // 被接受的變差提議
+        bool restored = false;             // 結束時還原成較好的 epoch
+    };
+
+    // index 必須與 netlist 同步；退火會同時更新兩者
+    Annealer(core::Netlist& nl, RowIndex& index, core::ThreadPool& pool);
+
+    Stats run(const AnnealOptions& opt);
+
+private:
+    // 帶邊界 pin 數的 bounding box (同 IncrementalHpwl::Box)
+    struct Box {
+        int xmin = numeric_limits<int>::max(), xmax = numeric_limits<int>::min();
+        int ymin = numeric_limits<int>::max(), ymax = numeric_limits<int>::min();
+        int nxmin = 0, nxmax = 0, nymin = 0, nymax = 0;
+        void add(int x, int y) {
+            if (x < xmin) { xmin = x; nxmin = 1; } else if (x == xmin) ++nxmin;
+            if (x > xmax) { xmax = x; nxmax = 1; } else if (x == xmax) ++nxmax;
+            if (y < ymin) { ymin = y; nymin = 1; } else if (y == ymin) ++nymin;
+            if (y > ymax) { ymax = y; nymax = 1; } else if (y == ymax) ++nymax;
+        }
+        long long hpwl() const { return xmin > xmax ? 0 : (long long)(xmax - xmin) + (ymax - ymin); }
+    };
+
+    struct Tile { int r0, r1, xl, xr; };
+
+    struct TileStats {
+        long long proposals = 0, accepted = 0, uphill = 0;
+        long long up_bins[64] = {};           // 所有變差提議的 delta 依 bit 長度分桶 (估計 T0 用)
+    };
+
+    // 每個執行緒一份
+    struct Workspace {
+        mt19937_64 rng;
+        vector<int> cells;                   // tile 擁有的單元 (局部編號 = 索引)
+        vector<int> cell_row, cell_site;     // 單元目前在 tile 的第幾條 row / 第幾個 site
+        vector<int> row_first, row_sites, row_off; // tile 內各 row 的第一個 site、site 數、occ 起點
+        vector<int> occ;                     // site -> 局部單元，-1 空、-2 障礙物
+        vector<int> nets;                    // 碰到的 net (局部編號 = 索引)
+        vector<Box> ext;                     // net 在 tile 外 pin 的 box
+        vector<long long> cur;               // net 目前的 HPWL
+        vector<int> net_pin_start, net_pins; // net -> 局部單元 (CSR)
+        vector<int> cell_net_start, cell_nets; // 單元 -> 局部 net (CSR)
+        vector<int> own_stamp;               // 大小 numNodes：tile 擁有的節點
+        vector<int> net_local, net_stamp;    // 大小 num_nets：net -> 局部 net
+        vector<int> eval_stamp;              // 試算時 net 去重
+        vector<pair<int, long long>> trial;  // 試算中 net 的新 HPWL
+        vector<int> found;                   // cellsIn 的結果
+        int stamp = 0, eval = 0;
+    };
+
+    core::Netlist& netlist;
+    RowIndex& index;
+    core::ThreadPool& pool;
+    vector<Workspace> workspaces;
+
+    vector<Box> boxes;                   // 同步後各 net 的 box
+    vector<int> snap_x, snap_y;          // epoch 開始時的座標 (tile 外的 pin 讀這份)
+    vector<Tile> tiles;
+    vector<TileStats> tile_stats;
+
+    // 同步所有 net 的 box，回傳 HPWL
+    long long sync();
+    void buildTiles(const AnnealOptions& opt, int row_off, int col_off);
+    // tile 的單元 / 佔用 / 局部 net；沒有可動單元回傳 false
+    bool setupTile(Workspace& ws, const Tile& t);
+    void annealTile(Workspace& ws, const Tile& t, double temperature, int moves_per_cell,
+                    const core::Deadline& deadline, TileStats& st);
+    // 試算 a 移到 (ax, ay)、b (>= 0 時) 移到 (bx, by) 的 delta，新的 net HPWL 留在 ws.trial
+    long long trialDelta(Workspace& ws, int a, int ax, int ay, int b, int bx, int by);
+    // tile row tr 的 site [site, site + count) 設為 value (超出範圍的部分忽略)
+    void markSites(Workspace& ws, int tr, int site, int count, int value);
+};
@@ -0,0 +1,152 @@
+#include "anytime_optimizer.hpp"
+#include "../core/hpwl_parallel.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+AnytimeOptimizer::AnytimeOptimizer(core::Design& d, core::Netlist& nl, DetailedPlacer& dp, core::ThreadPool& pool)
+    : design(d), netlist(nl), pool(pool), inc(nl), swapper(nl, index, inc),
+      reorder(nl, index, pool), shifter(nl), driver(d, nl, dp, pool) {}
+
+void AnytimeOptimizer::setup(const AnytimeOptions& opt) {
+    actions.clear();
+    auto window = [&](int sites, int rows) {
+        Action a;
+        a.kind = Kind::Window;
+        a.sites = max(8, sites);
+        a.rows = max(1, rows);
+        a.name = "window " + to_string(a.sites) + "x" + to_string(a.rows);
+        actions.push_back(a);
+    };
+    // 列表順序也是還沒跑過的動作的嘗試順序 (與固定流程相同)
+    if (opt.swap.passes > 0) actions.push_back({"global swap", Kind::GlobalSwap});
+    window(opt.window.window_sites, opt.window.window_rows);
+    if (opt.shift) actions.push_back({"shift", Kind::Shift});
+    if (opt.reorder.window > 1) actions.push_back({"reorder", Kind::Reorder});
+    window(opt.window.window_sites / 2, opt.window.window_rows / 2);
+    window(opt.window.window_sites * 2, opt.window.window_rows);
+}
+
+int AnytimeOptimizer::pick(const AnytimeOptions& opt) const {
+    const double left = opt.deadline.remaining();
+    int best = -1, fallback = -1;
+    for (int i = 0; i < (int)actions.size(); ++i) {
+        const Action& a = actions[i];
+        if (a.idle) continue;
+        if (a.runs == 0) return i;
+        if (fallback < 0 || a.rate() > actions[fallback].rate()) fallback = i;
+        if (a.seconds * opt.safety > left) continue;
+        if (best < 0 || a.rate() > actions[best].rate()) best = i;
+    }
+    // 都放不進剩餘時間時仍做改善率最高的，pass 到期會自己停下
+    return best >= 0 ? best : fallback;
+}
+
+void AnytimeOptimizer::step(Action& a, const AnytimeOptions& opt, const core::Deadline& deadline) {
+    switch (a.kind) {
+    case Kind::GlobalSwap: {
+        GlobalSwapOptions o = opt.swap;
+        o.passes = 1;
+        o.deadline = deadline;
+        inc.rebuild();
+        swapper.run(o);
+        break;
+    }
+    case Kind::Window: {
+        WindowOptions o = opt.window;
+        o.window_sites = a.sites;
+        o.window_rows = a.rows;
+        o.max_group = opt.max_group;
+        o.deadline = deadline;
+        // 與 WindowDriver::run 一樣，奇數次偏移半個視窗
+        bool odd = a.runs % 2;
+        driver.runPass(o, odd ? a.rows / 2 : 0, odd ? a.sites / 2 : 0);
+        break;
+    }
+    case Kind::Reorder: {
+        ReorderOptions o = opt.reorder;
+        o.passes = 1;
+        o.deadline = deadline;
+        reorder.run(o);
+        break;
+    }
+    case Kind::Shift:
+        shifter.deadline = deadline;
+        shifter.run(index);
+        break;
+    }
+}
+
+AnytimeOptimizer::Stats AnytimeOptimizer::run(const AnytimeOptions& opt) {
+    PDA_PROF_SCOPE("opt.anytime");
+    using Clock = chrono::steady_clock;
+    Stats st;
+    setup(opt);
+
+    const int n = netlist.num_insts;
+    auto t0 = Clock::now();
+    index.build(design, netlist);
+    const int base_bad = index.violations(); // 輸入本身的違規數，不能比它更多
+    long long hpwl = core::hpwl_counts_parallel(netlist, pool);
+    // 每一步之後都要做一次同樣的檢查，pass 要提早這麼多停下
+    const double check = chrono::duration<double>(Clock::now() - t0).count();
+    const core::Deadline pass_deadline = opt.deadline.earlier(check * opt.safety);
+    long long best = hpwl;
+    st.initial = hpwl;
+    best_x.assign(netlist.x.begin(), netlist.x.begin() + n);
+    best_y.assign(netlist.y.begin(), netlist.y.begin() + n);
+
+    int k;
+    int bad = base_bad;
+    while (!(st.timed_out = pass_deadline.expired()) && (k = pick(opt)) >= 0) {
+        Action& a = actions[k];
+        t0 = Clock::now();
+        step(a, opt, pass_deadline);
+        index.build(design, netlist);
+        long long after = core::hpwl_counts_parallel(netlist, pool);
+        bad = index.violations();
+
+        a.gain = hpwl - after;
+        a.seconds = chrono::duration<double>(Clock::now() - t0).count();
+        ++a.runs;
+        ++st.steps;
+        PDA_PROF_SAMPLE("anytime.step_gain", a.gain);
+
+        if (bad > base_bad || after > best) {
+            // 不該發生 (每個 pass 只接受合法的改善)；保險起見回到 best 並停用這個動作
+            copy(best_x.begin(), best_x.end(), netlist.x.begin());
+            copy(best_y.begin(), best_y.end(), netlist.y.begin());
+            index.build(design, netlist);
+            bad = index.violations();
+            after = best;
+            a.idle = true;
+            st.restored = true;
+        } else if (after < best) {
+            best = after;
+            copy(netlist.x.begin(), netlist.x.begin() + n, best_x.begin());
+            copy(netlist.y.begin(), netlist.y.begin() + n, best_y.begin());
+        }
+
+        if (opt.verbose) {
+            cout << "step " << st.steps << ' ' << a.name << " hpwl " << after << " gain " << a.gain
+                 << fixed << setprecision(3) << " (" << a.seconds << " s, "
+                 << max(0.0, opt.deadline.remaining()) << " s left)\n" << defaultfloat;
+        }
+
+        // 改善太小就擱置；有明顯改善時版面變了，其他擱置中的動作可能又有機會
+        if (a.gain < opt.tolerance * hpwl) {
+            a.idle = true;
+        } else {
+            for (Action& other : actions) {
+                if (&other != &a) other.idle = false;
+            }
+        }
+        hpwl = after;
+    }
+
+    st.final = hpwl;
+    st.violations = bad;
+    return st;
+}
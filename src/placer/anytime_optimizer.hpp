@@ -0,0 +1,91 @@
+#pragma once
+#include "../core/deadline.hpp"
+#include "../core/design.hpp"
+#include "../core/netlist.hpp"
+#include "../core/thread_pool.hpp"
+#include "detailed_placer.hpp"
+#include "global_swap.hpp"
+#include "incremental_hpwl.hpp"
+#include "row_index.hpp"
+#include "row_reorder.hpp"
+#include "row_shift.hpp"
+#include "window_driver.hpp"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 有時間限制的 anytime 最佳化
+// ==========================================
+// 把各種 detailed placement pass 當成可重複執行的「動作」：
+//   global swap / 三種大小的視窗指派 / row 內重排 / row segment 平移
+// 每做完一步就記下這個動作實際的 HPWL 改善量與花費時間，
+// 下一步挑「改善量 / 秒」最高、預估時間放得進剩餘時間的動作；
+// 還沒跑過的動作先各試一次。視窗大小也是這樣依實測結果挑選。
+// 改善比例低於 tolerance 的動作先擱置，其他動作有明顯改善時再恢復。
+//
+// 每個 pass 都在工作單位之間檢查 deadline，中途停下來的結果仍然合法。
+// 每一步之後檢查合法性，只把 HPWL 更好且合法的狀態記成 best，
+// 結束時若目前狀態不是 best 就還原，所以 deadline 一到就能直接寫檔。
+// deadline 要由呼叫端扣掉寫 DEF 需要的時間；每一步之後的檢查 (重建索引、HPWL)
+// 所需的時間由這裡量測後再從 pass 的 deadline 扣掉。
+struct AnytimeOptions {
+    core::Deadline deadline;       // 最佳化必須結束的時間點
+    WindowOptions window;          // 中間大小的視窗；另外會試一半與兩倍寬的視窗
+    GlobalSwapOptions swap;        // passes == 0 停用
+    ReorderOptions reorder;        // window <= 1 停用
+    bool shift = true;
+    double tolerance = 1e-4;       // 一步的改善比例低於此值就擱置該動作
+    double safety = 1.5;           // 預估時間的放大倍數
+    int max_group = 128;           // 視窗內同尺寸群組的上限，讓單一指派問題的時間有界
+    bool verbose = true;
+};
+
+class AnytimeOptimizer {
+public:
+    struct Stats {
+        long long initial = 0, final = 0;  // HPWL
+        int steps = 0;
+        bool timed_out = false;            // 因為 deadline 結束 (而不是所有動作都擱置)
+        bool restored = false;             // 有一步不合法或變差，還原成 best
+        int violations = 0;                // 結束時的重疊 / 不在格點上的單元數
+    };
+
+    AnytimeOptimizer(core::Design& d, core::Netlist& nl, DetailedPlacer& dp, core::ThreadPool& pool);
+
+    Stats run(const AnytimeOptions& opt);
+
+private:
+    enum class Kind { GlobalSwap, Window, Reorder, Shift };
+
+    struct Action {
+        string name;
+        Kind kind;
+        int sites = 0, rows = 0;       // Window 用
+        int runs = 0;
+        long long gain = 0;            // 最近一次的改善量
+        double seconds = 0;            // 最近一次的時間
+        bool idle = false;
+        double rate() const { return gain / max(seconds, 1e-6); }
+    };
+
+    core::Design& design;
+    core::Netlist& netlist;
+    core::ThreadPool& pool;
+
+    RowIndex index;                    // 每一步之後重建
+    IncrementalHpwl inc;
+    GlobalSwap swapper;
+    RowReorder reorder;
+    RowShift shifter;
+    WindowDriver driver;
+    vector<Action> actions;
+
+    vector<int> best_x, best_y;
+
+    void setup(const AnytimeOptions& opt);
+    // 下一個要做的動作，沒有可做的回傳 -1
+    int pick(const AnytimeOptions& opt) const;
+    void step(Action& a, const AnytimeOptions& opt, const core::Deadline& deadline);
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include "../core/netlist.hpp"
+#include "cost_matrix.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 稀疏候選圖：每個單元只保留 K 個候選 site
+// ==========================================
+// 大區域裡單元幾乎不會移到離 optimal region 很遠的 site，完整的 k x m 條邊大多沒用。
+// site 依 (row, x 分桶) 放進格子；每個單元從 optimal region 中心所在的格子
+// 一圈一圈往外收集 site，收滿 K 個之後再多看一圈 (隔壁格子裡可能有更好的)，
+// 留下成本最低的 K 個。
+// 單元 i 一定包含 site i：呼叫端傳入的 sites 就是各單元目前的位置 (依 modules 順序)，
+// 原本的排列一定可行，所以完美匹配一定存在，結果也不會比原本差。邊數 O(k * K)。
+class CandidateGraph {
+public:
+    // CSR：module i 的候選是 site[start[i] .. start[i + 1])，cost 為對應的成本
+    vector<int> start, site;
+    vector<long long> cost;
+
+    template <class Sites>
+    void build(const core::Netlist& nl, const vector<int>& modules, const Sites& sites, int K,
+               CostMatrixBuilder& costs) {
+        const int k = (int)modules.size(), m = (int)sites.size();
+        costs.prepare(sites);
+        build_grid(costs, m);
+
+        start.assign(1, 0);
+        site.clear();
+        cost.clear();
+        for (int i = 0; i < k; ++i) {
+            costs.evalModule(nl, modules[i]);
+            collect(costs, K);
+
+            // 成本最低的 K 個 (同成本依 site 編號，結果固定)，再依 site 編號排好
+            if ((int)found.size() > K) {
+                nth_element(found.begin(), found.begin() + K, found.end());
+                found.resize(K);
+            }
+            bool self = false;
+            for (const auto& f : found) self |= (f.second == i);
+            if (!self && i < m) found.push_back({costs.cost(i), i});
+            sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+
+            for (const auto& f : found) {
+                site.push_back(f.second);
+                cost.push_back(f.first);
+            }
+            start.push_back((int)site.size());
+        }
+    }
+
+private:
+    int nx = 1, ny = 1, nbx = 1;     // 不同的 x / row 數，每條 row 的 x 桶數
+    vector<int> cell_start, cell_sites, cell_pos;
+    vector<pair<long long, int>> found; // (成本, site)
+
+    int binOf(int xi) const { return int((long long)xi * nbx / nx); }
+
+    // 平均每格約 4 個 site
+    void build_grid(const CostMatrixBuilder& costs, int m) {
+        nx = max(1, (int)costs.distinctX().size());
+        ny = max(1, (int)costs.distinctY().size());
+        nbx = max(1, min(nx, m / (ny * 4)));
+
+        const int cells = ny * nbx;
+        cell_start.assign(cells + 1, 0);
+        for (int j = 0; j < m; ++j) ++cell_start[costs.siteY(j) * nbx + binOf(costs.siteX(j)) + 1];
+        for (int c = 0; c < cells; ++c) cell_start[c + 1] += cell_start[c];
+        cell_sites.resize(m);
+        cell_pos.assign(cell_start.begin(), cell_start.end() - 1);
+        for (int j = 0; j < m; ++j) cell_sites[cell_pos[costs.siteY(j) * nbx + binOf(costs.siteX(j))]++] = j;
+    }
+
+    // 最接近 v 的索引
+    static int nearest(const vector<int>& sorted, int v) {
+        int i = int(lower_bound(sorted.begin(), sorted.end(), v) - sorted.begin());
+        if (i == (int)sorted.size()) return i - 1;
+        if (i > 0 && v - sorted[i - 1] < sorted[i] - v) return i - 1;
+        return i;
+    }
+
+    void visit(const CostMatrixBuilder& costs, int y, int b) {
+        if (y < 0 || y >= ny || b < 0 || b >= nbx) return;
+        const int c = y * nbx + b;
+        for (int p = cell_start[c]; p < cell_start[c + 1]; ++p) {
+            const int j = cell_sites[p];
+            found.push_back({costs.cost(j), j});
+        }
+    }
+
+    // 從中心所在的格子一圈一圈往外收集，收滿 K 個之後再多收一圈
+    void collect(const CostMatrixBuilder& costs, int K) {
+        found.clear();
+        const int yc = nearest(costs.distinctY(), costs.centerY());
+        const int bc = binOf(nearest(costs.distinctX(), costs.centerX()));
+        const int max_r = max(ny, nbx);
+        int full_at = -1;
+        for (int r = 0; r <= max_r; ++r) {
+            for (int dy = -r; dy <= r; ++dy) {
+                if (dy == -r || dy == r) {
+                    for (int db = -r; db <= r; ++db) visit(costs, yc + dy, bc + db);
+                } else {
+                    visit(costs, yc + dy, bc - r);
+                    visit(costs, yc + dy, bc + r);
+                }
+            }
+            if (full_at < 0 && (int)found.size() >= K) full_at = r;
+            if (full_at >= 0 && r > full_at) break;
+        }
+    }
+};
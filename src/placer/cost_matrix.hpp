@@ -0,0 +1,155 @@
+#pragma once
+#include "../core/netlist.hpp"
+#include "frozen_nets.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 區域指派的成本矩陣 (可分離的 x / y 成本)
+// ==========================================
+// cost[i][j] = 單元 i 移到 site j、其餘節點不動時，i 所連 net 的 HPWL 總和
+// (與 DetailedPlacer::calculate_cost 逐項相同)。
+// HPWL 在 x / y 上可分離，而且對單元 i 而言每條 net 其餘節點的 bounding box
+// 與 i 放在哪裡無關，所以：
+//   1. 每個單元先算一次各 net 去掉自己之後的 box [lo, hi]
+//   2. 放在座標 s 的成本 = (hi - lo) + max(0, s - hi) + max(0, lo - s)，
+//      對所有 net 加總是 s 的分段線性函數；把 lo / hi 排序後掃過排序好的
+//      不同 site x (不同 row y)，每個座標 O(1)
+//   3. cost[i][j] = X[i][x(j)] + Y[i][y(j)]
+// 複雜度 O(k * (pins + (nets + X + Y) log)) + O(k * m)，
+// 原本逐項計算是 O(k * m * nets * pins)。工作陣列在多次 build 之間重複使用。
+// frozen 非空時，固定的 net 以其 box 當 [lo, hi] (見 FrozenNets)。
+class CostMatrixBuilder {
+public:
+    const FrozenNets* frozen = nullptr;
+
+    // sites[j].x / sites[j].y；cost 大小 k * m (row-major)
+    template <class Sites>
+    void build(const core::Netlist& nl, const vector<int>& modules, const Sites& sites, vector<long long>& cost) {
+        const int k = (int)modules.size(), m = (int)sites.size();
+        cost.resize((size_t)k * m);
+        if (k == 0 || m == 0) return;
+
+        prepare(sites);
+        for (int i = 0; i < k; ++i) {
+            evalModule(nl, modules[i]);
+            long long* row = cost.data() + (size_t)i * m;
+            for (int j = 0; j < m; ++j) row[j] = cx[site_xi[j]] + cy[site_yi[j]];
+        }
+    }
+
+    // 以下讓呼叫端只取部分項目 (CandidateGraph)：prepare 一次，每個單元 evalModule 一次
+
+    // 不同的 site x / row y，以及每個 site 對應的索引
+    template <class Sites>
+    void prepare(const Sites& sites) {
+        const int m = (int)sites.size();
+        xs.resize(m);
+        ys.resize(m);
+        for (int j = 0; j < m; ++j) { xs[j] = sites[j].x; ys[j] = sites[j].y; }
+        sort_unique(xs);
+        sort_unique(ys);
+        site_xi.resize(m);
+        site_yi.resize(m);
+        for (int j = 0; j < m; ++j) {
+            site_xi[j] = int(lower_bound(xs.begin(), xs.end(), sites[j].x) - xs.begin());
+            site_yi[j] = int(lower_bound(ys.begin(), ys.end(), sites[j].y) - ys.begin());
+        }
+        cx.resize(xs.size());
+        cy.resize(ys.size());
+    }
+
+    // inst 在每個不同 x / y 的成本，以及 optimal region 的中心
+    void evalModule(const core::Netlist& nl, int inst) {
+        // 各 net 去掉 inst 之後的 box；只剩 inst 自己的 net 成本恆為 0
+        lo_x.clear(); hi_x.clear(); lo_y.clear(); hi_y.clear();
+        for (int t = nl.instBegin(inst); t < nl.instEnd(inst); ++t) {
+            const int n = nl.inst_nets[t];
+            if (frozen && frozen->frozen(nl, n)) {
+                const FrozenNets::Box& b = frozen->box[n];
+                lo_x.push_back(b.xmin); hi_x.push_back(b.xmax);
+                lo_y.push_back(b.ymin); hi_y.push_back(b.ymax);
+                continue;
+            }
+            int min_x = numeric_limits<int>::max(), max_x = numeric_limits<int>::min();
+            int min_y = numeric_limits<int>::max(), max_y = numeric_limits<int>::min();
+            bool any = false;
+            for (int p = nl.netBegin(n); p < nl.netEnd(n); ++p) {
+                const int node = nl.net_pins[p];
+                if (node == inst) continue;
+                any = true;
+                min_x = min(min_x, nl.x[node]);
+                max_x = max(max_x, nl.x[node]);
+                min_y = min(min_y, nl.y[node]);
+                max_y = max(max_y, nl.y[node]);
+            }
+            if (!any) continue;
+            lo_x.push_back(min_x); hi_x.push_back(max_x);
+            lo_y.push_back(min_y); hi_y.push_back(max_y);
+        }
+
+        axis_costs(lo_x, hi_x, xs, cx);
+        axis_costs(lo_y, hi_y, ys, cy);
+        center_x = lo_x.empty() ? nl.x[inst] : median_center(lo_x, hi_x);
+        center_y = lo_y.empty() ? nl.y[inst] : median_center(lo_y, hi_y);
+    }
+
+    // evalModule 之後：放到 site j 的成本
+    long long cost(int j) const { return cx[site_xi[j]] + cy[site_yi[j]]; }
+
+    // evalModule 之後：optimal region (使 HPWL 總和最小的範圍) 的中心
+    int centerX() const { return center_x; }
+    int centerY() const { return center_y; }
+
+    // prepare 之後：排序好的不同 x / y，與 site j 在其中的索引
+    const vector<int>& distinctX() const { return xs; }
+    const vector<int>& distinctY() const { return ys; }
+    int siteX(int j) const { return site_xi[j]; }
+    int siteY(int j) const { return site_yi[j]; }
+
+private:
+    vector<int> xs, ys, site_xi, site_yi;
+    vector<int> lo_x, hi_x, lo_y, hi_y;
+    vector<long long> cx, cy;
+    int center_x = 0, center_y = 0;
+
+    static void sort_unique(vector<int>& v) {
+        sort(v.begin(), v.end());
+        v.erase(unique(v.begin(), v.end()), v.end());
+    }
+
+    // out[c] = sum_n (hi_n - lo_n) + max(0, s_c - hi_n) + max(0, lo_n - s_c)，s 已排序。
+    // lo / hi 會被排序 (呼叫端不再需要兩者的對應關係)
+    static void axis_costs(vector<int>& lo, vector<int>& hi, const vector<int>& s, vector<long long>& out) {
+        const int n = (int)lo.size();
+        long long base = 0, lo_sum = 0;
+        for (int t = 0; t < n; ++t) { base += (long long)hi[t] - lo[t]; lo_sum += lo[t]; }
+        sort(lo.begin(), lo.end());
+        sort(hi.begin(), hi.end());
+
+        // a：hi < s 的 net 數 / 總和；b：lo <= s 的 net 數 / 總和
+        int a = 0, b = 0;
+        long long hi_below = 0, lo_below = 0;
+        for (size_t c = 0; c < s.size(); ++c) {
+            const long long x = s[c];
+            while (a < n && hi[a] < x) hi_below += hi[a++];
+            while (b < n && lo[b] <= x) lo_below += lo[b++];
+            out[c] = base + (a * x - hi_below) + ((lo_sum - lo_below) - (long long)(n - b) * x);
+        }
+    }
+
+    // 已排序的 lo / hi 合起來 2n 個值的中位數區間 [第 n 小, 第 n+1 小] 的中點；
+    // 整個區間上成本都是最小值
+    static int median_center(const vector<int>& lo, const vector<int>& hi) {
+        const size_t n = lo.size();
+        size_t a = 0, b = 0;
+        auto pop = [&]() { return (b >= n || (a < n && lo[a] <= hi[b])) ? lo[a++] : hi[b++]; };
+        int left = 0;
+        for (size_t c = 0; c < n; ++c) left = pop();
+        int right = pop();
+        return int(((long long)left + right) / 2);
+    }
+};
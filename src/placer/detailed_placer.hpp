@@ -1,5 +1,12 @@
 #pragma once
 #include "../core/design.hpp"
+#include "../core/netlist.hpp"
+#include "../core/profiler.hpp"
+#include "candidate_graph.hpp"
+#include "cost_matrix.hpp"
+#include "frozen_nets.hpp"
+#include "lap_solver.hpp"
+#include "min_cost_flow.hpp"
 #include <vector>
 #include <string>
 #include <queue>
@@ -11,175 +18,182 @@
 using namespace std;
 
 // ==========================================
-// 1. Min-Cost Max-Flow (MCMF) Solver
-// ==========================================
-class MinCostMaxFlow {
-public:
-    struct Edge {
-        int to;
-        int capacity;
-        int flow;
-        long long cost; // 使用 long long 避免 HPWL 加總溢位
-        int rev; // 反向邊在 adjacency list 中的索引
-    };
-
-    vector<vector<Edge>> adj;
-    vector<long long> dist;
-    vector<int> parent_edge;
-    vector<int> parent_node;
-    int n;
-    int s, t;
-
-    MinCostMaxFlow(int num_nodes, int source, int sink) : n(num_nodes), s(source), t(sink) {
-        adj.resize(n);
-        dist.resize(n);
-        parent_edge.resize(n);
-        parent_node.resize(n);
-    }
-
-    void add_edge(int u, int v, int cap, long long cost) {
-        Edge a = {v, cap, 0, cost, (int)adj[v].size()};
-        Edge b = {u, 0, 0, -cost, (int)adj[u].size()}; // 反向邊容量為 0，成本為負
-        adj[u].push_back(a);
-        adj[v].push_back(b);
-    }
-
-    // 使用 SPFA 尋找最短路徑 (在有負權邊但無負環的圖中適用，這裡其實只有正權，也可以用 Dijkstra)
-    bool spfa() {
-        fill(dist.begin(), dist.end(), numeric_limits<long long>::max());
-        vector<bool> in_queue(n, false);
-        queue<int> q;
-
-        dist[s] = 0;
-        q.push(s);
-        in_queue[s] = true;
-
-        while (!q.empty()) {
-            int u = q.front();
-            q.pop();
-            in_queue[u] = false;
-
-            for (int i = 0; i < adj[u].size(); ++i) {
-                Edge &e = adj[u][i];
-                if (e.capacity - e.flow > 0 && dist[e.to] > dist[u] + e.cost) {
-                    dist[e.to] = dist[u] + e.cost;
-                    parent_node[e.to] = u;
-                    parent_edge[e.to] = i;
-                    if (!in_queue[e.to]) {
-                        q.push(e.to);
-                        in_queue[e.to] = true;
-                    }
-                }
-            }
-        }
-        return dist[t] != numeric_limits<long long>::max();
-    }
-
-    pair<int, long long> solve() {
-        int total_flow = 0;
-        long long total_cost = 0;
-
-        while (spfa()) {
-            int push = numeric_limits<int>::max();
-            int curr = t;
-            while (curr != s) {
-                int prev = parent_node[curr];
-                int edge_idx = parent_edge[curr];
-                push = min(push, adj[prev][edge_idx].capacity - adj[prev][edge_idx].flow);
-                curr = prev;
-            }
-
-            total_flow += push;
-            curr = t;
-            while (curr != s) {
-                int prev = parent_node[curr];
-                int edge_idx = parent_edge[curr];
-                adj[prev][edge_idx].flow += push;
-                int rev_idx = adj[prev][edge_idx].rev;
-                adj[curr][rev_idx].flow -= push;
-                total_cost += (long long)push * adj[prev][edge_idx].cost;
-                curr = prev;
-            }
-        }
-        return {total_flow, total_cost};
-    }
-};
-
-// ==========================================
-// 2. Detailed Placer Class
+// Detailed Placer Class
 // ==========================================
+// 所有熱迴圈都在 core::Netlist 的整數 ID / SoA 座標上做，
+// 結束後再由呼叫端 netlist.writeBack(design) 寫回。
 class DetailedPlacer {
 public:
     core::Design& design;
+    core::Netlist& netlist;
 
-    DetailedPlacer(core::Design& d) : design(d) {}
+    DetailedPlacer(core::Design& d, core::Netlist& nl) : design(d), netlist(nl) {}
 
     // 一個簡單的座標結構
     struct Pos { int x, y; };
 
+    // 非空時，固定的 net (平行視窗之間不算衝突的高扇出 net) 改用其 box 計算成本，
+    // 不讀其他單元目前的座標；由 WindowScheduler::frozen() 提供
+    const FrozenNets* frozen = nullptr;
+
     // 計算 HPWL 的輔助函數
-    long long compute_net_hpwl(const core::Net& net, const string& moving_inst_name, int new_x, int new_y) {
-        long long min_x = numeric_limits<long long>::max();
-        long long min_y = numeric_limits<long long>::max();
-        long long max_x = numeric_limits<long long>::min();
-        long long max_y = numeric_limits<long long>::min();
+    long long compute_net_hpwl(int net, int moving_inst, int new_x, int new_y) const {
+        const core::Netlist& nl = netlist;
+        int b = nl.netBegin(net), e = nl.netEnd(net);
+        // 如果 net 沒有 pin，HPWL 為 0
+        if (b == e) return 0;
+        if (frozen && frozen->frozen(nl, net)) {
+            FrozenNets::Box box = frozen->box[net];
+            box.add(new_x, new_y);
+            return box.hpwl();
+        }
+
+        int min_x = numeric_limits<int>::max(), max_x = numeric_limits<int>::min();
+        int min_y = numeric_limits<int>::max(), max_y = numeric_limits<int>::min();
 
         // 根據 spec，pin 位置簡化為 instance 的左下角座標
-        // 遍歷這個 net 連接的所有 instance
-        for (const string& inst_name : net.insts) {
-            int cur_x, cur_y;
-            if (inst_name == moving_inst_name) {
-                // 如果是我們正在嘗試移動的單元，使用新的測試座標
-                cur_x = new_x;
-                cur_y = new_y;
-            } else {
-                // 否則使用它目前在 Design 中的座標
-                // 注意：這裡需要能快速從 design 中找到 instance。
-                // 假設 design.instances 是一個 map<string, Instance>
-                const auto& other_inst = design.instances.at(inst_name);
-                cur_x = other_inst.x;
-                cur_y = other_inst.y;
-            }
-            min_x = min(min_x, (long long)cur_x);
-            max_x = max(max_x, (long long)cur_x);
-            min_y = min(min_y, (long long)cur_y);
-            max_y = max(max_y, (long long)cur_y);
+        for (int k = b; k < e; ++k) {
+            int node = nl.net_pins[k];
+            // 正在嘗試移動的單元用新的測試座標，其餘用目前座標
+            int cur_x = (node == moving_inst) ? new_x : nl.x[node];
+            int cur_y = (node == moving_inst) ? new_y : nl.y[node];
+            min_x = min(min_x, cur_x);
+            max_x = max(max_x, cur_x);
+            min_y = min(min_y, cur_y);
+            max_y = max(max_y, cur_y);
         }
 
-        // 如果 net 只有一個 pin 或沒有 pin，HPWL 為 0
-        if (min_x == numeric_limits<long long>::max()) return 0;
-
-        return (max_x - min_x) + (max_y - min_y);
+        return (long long)(max_x - min_x) + (max_y - min_y);
     }
 
     // 計算將單元 inst 放到位置 (site_x, site_y) 的總成本
-    long long calculate_cost(const string& inst_name, int site_x, int site_y) {
+    // (assignRegion 的成本矩陣由 CostMatrixBuilder 以可分離的方式一次算出，結果相同)
+    long long calculate_cost(int inst, int site_x, int site_y) const {
         long long total_cost = 0;
-        const auto& inst = design.instances.at(inst_name);
         // 遍歷該單元連接的所有 net
-        for (const string& net_name : inst.nets) {
-             // 假設 design.nets 是一個 map<string, Net>
-            const auto& net = design.nets.at(net_name);
-            total_cost += compute_net_hpwl(net, inst_name, site_x, site_y);
+        for (int k = netlist.instBegin(inst); k < netlist.instEnd(inst); ++k) {
+            total_cost += compute_net_hpwl(netlist.inst_nets[k], inst, site_x, site_y);
         }
         return total_cost;
     }
 
+    // 區域指派的求解器：兩者都給出最佳解
+    //  - LAP : 直接在 k x m 成本矩陣上做 dense linear assignment
+    //  - MCMF: 一般的 min-cost max-flow (source -> module -> site -> sink)
+    enum class MatchSolver { LAP, MCMF };
+    MatchSolver solver = MatchSolver::LAP;
+
+    // > 0 且 site 數多於此值時，每個單元只保留這麼多個候選 site (CandidateGraph)，
+    // 改在 O(k * K) 條邊的稀疏圖上求解 (LAP -> SparseAssignment)；0 為完整的 k x m 成本矩陣
+    int candidates = 0;
+
     // =====================================================
-    // 核心演算法：給定一個區域的單元和空位，進行 MCMF 最佳化
-    // modules: 要在這個區域內重新排列的單元名稱列表 (C_i)
+    // 核心演算法：給定一個區域的單元和空位，求最小成本的指派
+    // modules: 要在這個區域內重新排列的單元 ID 列表 (C_i)
     // sites: 這個區域內可用的合法位置座標列表 (P_j)
+    // assignment[i]: module i 被指派到的 site 索引 (失敗為 -1)
+    // init[i]: 可選的初始指派 (通常是目前的位置)，LAP 以此 warm start；MCMF 不使用
+    // 稀疏候選圖 (candidates) 的前提：sites[i] 是 modules[i] 目前的位置。site i 一定是 module i
+    // 的候選，所以結果不會比原本差 (不符合前提時只保證是合法指派)；稀疏圖若仍無解就改用完整的成本矩陣
+    // 只計算不修改座標；回傳 false 表示輸入不合法
     // =====================================================
-    void solveRegion(const vector<string>& modules, const vector<Pos>& sites) {
+    bool assignRegion(const vector<int>& modules, const vector<Pos>& sites, vector<int>& assignment,
+                      const int* init = nullptr) {
         int k = modules.size(); // 單元數量
         int m = sites.size();   // 位置數量
 
-        if (k == 0 || m == 0) return;
+        assignment.clear();
+        if (k == 0 || m == 0) return false;
         if (k > m) {
             cerr << "Error: More modules than sites in region!" << endl;
-            return;
+            return false;
         }
 
+        PDA_PROF_COUNT("placer.regions", 1);
+        PDA_PROF_COUNT("placer.region_cells", k);
+        costs.frozen = frozen;
+
+        if (candidates > 0 && m > candidates) {
+            graph.build(netlist, modules, sites, candidates, costs);
+            PDA_PROF_COUNT("placer.sparse_regions", 1);
+            PDA_PROF_COUNT("placer.cost_evals", (long long)graph.site.size());
+            const bool ok = solver == MatchSolver::LAP
+                                 ? sparse_lap.solve(graph.start.data(), graph.site.data(), graph.cost.data(), k, m,
+                                                    assignment, init)
+                                 : match_sparse(k, m, assignment);
+            if (ok) return true;
+            PDA_PROF_COUNT("placer.sparse_fallbacks", 1);
+        }
+        PDA_PROF_COUNT("placer.cost_evals", (long long)k * m); // 成本矩陣的項數
+
+        // 1. 建立 k x m 成本矩陣 (row-major)，每項等於 calculate_cost(modules[i], sites[j])
+        costs.build(netlist, modules, sites, cost_matrix);
+
+        // 2. 求解指派
+        if (solver == MatchSolver::LAP) {
+            lap.solve(cost_matrix.data(), k, m, assignment, init);
+        } else {
+            match_mcmf(k, m, assignment);
+        }
+        return true;
+    }
+
+    // 求解並直接更新單元位置
+    void solveRegion(const vector<int>& modules, const vector<Pos>& sites) {
+        if (!assignRegion(modules, sites, assignment)) return;
+
+        // 注意：這裡直接修改了 netlist 的座標
+        for (int i = 0; i < (int)modules.size(); ++i) {
+            int site_idx = assignment[i];
+            if (site_idx < 0) continue;
+            netlist.x[modules[i]] = sites[site_idx].x;
+            netlist.y[modules[i]] = sites[site_idx].y;
+        }
+    }
+
+private:
+    vector<long long> cost_matrix;
+    CostMatrixBuilder costs;
+    CandidateGraph graph;
+    vector<int> assignment;
+    LinearAssignment lap;
+    SparseAssignment sparse_lap;
+    MinCostMaxFlow mcmf;
+
+    // 以 MCMF 求解 graph 上的指派；沒有完美匹配時回傳 false
+    bool match_sparse(int k, int m, vector<int>& assignment) {
+        // 節點編號與 match_mcmf 相同
+        int S = 0;
+        int T = k + m + 1;
+        mcmf.reset(T + 1, S, T);
+        for (int i = 0; i < k; ++i) mcmf.add_edge(S, i + 1, 1, 0);
+        for (int j = 0; j < m; ++j) mcmf.add_edge(k + 1 + j, T, 1, 0);
+
+        // 候選邊的 id = first + 在 graph 中的位置
+        const int first = mcmf.num_edges();
+        for (int i = 0; i < k; ++i) {
+            for (int e = graph.start[i]; e < graph.start[i + 1]; ++e) {
+                mcmf.add_edge(i + 1, k + 1 + graph.site[e], 1, graph.cost[e]);
+            }
+        }
+
+        pair<int, long long> result = mcmf.solve();
+        assignment.assign(k, -1);
+        if (result.first != k) return false;
+
+        for (int i = 0; i < k; ++i) {
+            for (int e = graph.start[i]; e < graph.start[i + 1]; ++e) {
+                if (mcmf.flow(first + e) == 1) {
+                    assignment[i] = graph.site[e];
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    // 以 MCMF 求解 cost_matrix 上的指派，結果寫入 assignment
+    void match_mcmf(int k, int m, vector<int>& assignment) {
         // 節點編號：
         // Source S = 0
         // Sink T = k + m + 1
@@ -187,7 +201,7 @@ public:
         // Sites P_j = k + 1 ... k + m
         int S = 0;
         int T = k + m + 1;
-        MinCostMaxFlow mcmf(T + 1, S, T);
+        mcmf.reset(T + 1, S, T);
 
         // 1. 建立從 Source 到每個 Module 的邊
         for (int i = 0; i < k; ++i) {
@@ -199,17 +213,15 @@ public:
             mcmf.add_edge(k + 1 + j, T, 1, 0); // 容量 1，成本 0
         }
 
-        // 3. 建立從每個 Module 到每個 Site 的邊，並計算成本
-        // 這是最耗時的部分，複雜度 O(k * m * avg_nets_per_cell * avg_pins_per_net)
+        // 3. 建立從每個 Module 到每個 Site 的邊 (邊 id = first + i * m + j)
+        const int first = mcmf.num_edges();
         for (int i = 0; i < k; ++i) {
             for (int j = 0; j < m; ++j) {
-                long long cost = calculate_cost(modules[i], sites[j].x, sites[j].y);
-                mcmf.add_edge(i + 1, k + 1 + j, 1, cost);
+                mcmf.add_edge(i + 1, k + 1 + j, 1, cost_matrix[(size_t)i * m + j]);
             }
         }
 
         // 4. 求解 MCMF
-        // cout << "Running MCMF for region with " << k << " modules and " << m << " sites..." << endl;
         pair<int, long long> result = mcmf.solve();
 
         if (result.first != k) {
@@ -217,24 +229,15 @@ public:
             // 在實際應用中，這裡可能需要 fallback 策略，或者這意味著輸入有問題
         }
 
-        // 5. 解析結果並更新單元位置
-        // 檢查從 Module 節點出發的所有邊，找出有流量的邊
+        // 5. 解析結果：找出 Module -> Site 有流量的邊
+        assignment.assign(k, -1);
         for (int i = 0; i < k; ++i) {
-            int u = i + 1; // Module C_i 的節點編號
-            for (const auto& e : mcmf.adj[u]) {
-                // 如果這條邊有流量 (flow == 1)，且是指向 Site 節點的
-                if (e.flow == 1 && e.to > k && e.to <= k + m) {
-                    int site_idx = e.to - (k + 1); // 取得 Site 的索引 j
-                    
-                    // 更新設計中單元的座標
-                    // 注意：這裡直接修改了 design 的全域狀態
-                    design.instances.at(modules[i]).x = sites[site_idx].x;
-                    design.instances.at(modules[i]).y = sites[site_idx].y;
-                    
-                    // cout << "Moved " << modules[i] << " to (" << sites[site_idx].x << ", " << sites[site_idx].y << ")" << endl;
-                    break; 
+            for (int j = 0; j < m; ++j) {
+                if (mcmf.flow(first + i * m + j) == 1) {
+                    assignment[i] = j;
+                    break;
                 }
             }
         }
     }
-};
\ No newline at end of file
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include "../core/netlist.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 高扇出 net 的固定 bounding box
+// ==========================================
+// 平行處理視窗時，reset / enable 這類 net 幾乎連到每個視窗；若算成衝突，
+// 所有視窗都會被排進不同的 batch。degree 超過 max_degree 的 net 改用 WindowScheduler::build
+// 當下的 box (含自己的 pin)：放在 (x, y) 的成本是 box 加上這一點後的 HPWL，
+// 不讀其他視窗正在寫的座標，結果固定且與執行緒數無關。
+struct FrozenNets {
+    struct Box {
+        int xmin = numeric_limits<int>::max(), xmax = numeric_limits<int>::min();
+        int ymin = numeric_limits<int>::max(), ymax = numeric_limits<int>::min();
+        void add(int x, int y) {
+            xmin = min(xmin, x); xmax = max(xmax, x);
+            ymin = min(ymin, y); ymax = max(ymax, y);
+        }
+        long long hpwl() const { return xmin > xmax ? 0 : (long long)(xmax - xmin) + (ymax - ymin); }
+    };
+
+    int max_degree = 0;   // 0：沒有固定的 net
+    vector<Box> box;      // 大小 num_nets；只有這次 build 碰到的固定 net 有效
+
+    bool frozen(const core::Netlist& nl, int net) const {
+        return max_degree > 0 && nl.netDegree(net) > max_degree;
+    }
+};
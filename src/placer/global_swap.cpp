@@ -0,0 +1,130 @@
+#include "global_swap.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <limits>
+
+bool GlobalSwap::optimalRegion(int inst, int max_degree, int& xlo, int& xhi, int& ylo, int& yhi) {
+    xs.clear();
+    ys.clear();
+    for (int k = netlist.instBegin(inst); k < netlist.instEnd(inst); ++k) {
+        int n = netlist.inst_nets[k];
+        int deg = netlist.netDegree(n);
+        if (deg < 2 || deg > max_degree) continue;
+
+        int bx0 = numeric_limits<int>::max(), bx1 = numeric_limits<int>::min();
+        int by0 = numeric_limits<int>::max(), by1 = numeric_limits<int>::min();
+        for (int q = netlist.netBegin(n); q < netlist.netEnd(n); ++q) {
+            int node = netlist.net_pins[q];
+            if (node == inst) continue;
+            bx0 = min(bx0, netlist.x[node]);
+            bx1 = max(bx1, netlist.x[node]);
+            by0 = min(by0, netlist.y[node]);
+            by1 = max(by1, netlist.y[node]);
+        }
+        xs.push_back(bx0); xs.push_back(bx1);
+        ys.push_back(by0); ys.push_back(by1);
+    }
+    if (xs.empty()) return false;
+
+    // 2k 個邊界值，中間兩個之間的區間都是最佳位置
+    sort(xs.begin(), xs.end());
+    sort(ys.begin(), ys.end());
+    size_t h = xs.size() / 2;
+    xlo = xs[h - 1]; xhi = xs[h];
+    ylo = ys[h - 1]; yhi = ys[h];
+    return true;
+}
+
+bool GlobalSwap::improveCell(int inst, const GlobalSwapOptions& opt, Stats& st) {
+    if (netlist.fixed[inst] || index.rowOfInst(inst) < 0) return false;
+    // 只動單一 row 高、位置合法的單元：交換 / 空隙都只檢查一條 row，
+    // 位置不合法的單元換出去會把對方換到不合法的位置
+    auto single_row = [&](int c) {
+        int r = index.rowOf(netlist.y[c]);
+        return r >= 0 && netlist.height[c] == index.row(r).height && index.onGrid(r, netlist.x[c], netlist.width[c]);
+    };
+    if (!single_row(inst)) return false;
+
+    int xlo, xhi, ylo, yhi;
+    if (!optimalRegion(inst, opt.max_net_degree, xlo, xhi, ylo, yhi)) return false;
+    const int x = netlist.x[inst], y = netlist.y[inst], w = netlist.width[inst];
+    if (xlo <= x && x <= xhi && ylo <= y && y <= yhi) return false;
+
+    // 區域可能只是一個點，左右各放寬一個單元寬度
+    const int xl = xlo - w, xr = xhi + w;
+    int r0 = index.nearestRow(ylo), r1 = index.nearestRow(yhi);
+    if (index.row(r1).y < yhi && r1 + 1 < index.numRows()) ++r1;
+
+    long long best = 0;
+    int best_swap = -1, best_x = 0, best_y = 0;
+    int tried = 0;
+
+    // 1. 與區域內同寬度的單元交換
+    cands.clear();
+    index.cellsIn(r0, r1, xl, xr, cands);
+    for (int c : cands) {
+        if (tried >= opt.max_candidates) break;
+        if (c == inst || netlist.fixed[c] || netlist.width[c] != w) continue;
+        if (netlist.x[c] < xl || netlist.x[c] > xr || !single_row(c)) continue;
+        ++tried;
+        long long d = inc.delta_swap(inst, c);
+        if (d < best) { best = d; best_swap = c; }
+    }
+
+    // 2. 移到區域內夠寬的空隙 (在空隙內取最靠近區域中心、對齊 site 的位置)
+    const int mid = xlo + (xhi - xlo) / 2;
+    for (int r = r0; r <= r1 && tried < opt.max_candidates; ++r) {
+        const RowIndex::Row& row = index.row(r);
+        if (row.height != netlist.height[inst]) continue;
+        gaps.clear();
+        index.freeGaps(r, xl, xr + w, w, gaps);
+        for (const auto& g : gaps) {
+            if (tried >= opt.max_candidates) break;
+            const RowIndex::Segment& sg = row.segs[g.seg];
+            int tx = min(max(mid, g.x0), g.x1 - w);
+            tx = sg.x0 + (tx - sg.x0) / sg.step * sg.step;
+            if (tx < g.x0) tx += sg.step;
+            if (tx + w > g.x1 || !index.isFree(r, tx, w, inst)) continue;
+            ++tried;
+            long long d = inc.delta_move(inst, tx, row.y);
+            if (d < best) { best = d; best_swap = -1; best_x = tx; best_y = row.y; }
+        }
+    }
+
+    if (best >= 0) return false;
+
+    // 重新試算最佳候選後 commit，並同步 RowIndex
+    if (best_swap >= 0) {
+        int cx = netlist.x[best_swap], cy = netlist.y[best_swap];
+        inc.delta_swap(inst, best_swap);
+        inc.commit();
+        index.move(inst, cx, cy);
+        index.move(best_swap, x, y);
+        ++st.swaps;
+    } else {
+        inc.delta_move(inst, best_x, best_y);
+        inc.commit();
+        index.move(inst, best_x, best_y);
+        ++st.moves;
+    }
+    st.gain -= best;
+    return true;
+}
+
+GlobalSwap::Stats GlobalSwap::run(const GlobalSwapOptions& opt) {
+    PDA_PROF_SCOPE("opt.global_swap");
+    Stats st;
+    bool stop = false;
+    for (int p = 0; p < opt.passes && !stop; ++p) {
+        long long before = st.gain;
+        for (int i = 0; i < netlist.num_insts; ++i) {
+            if ((i & 255) == 0 && opt.deadline.expired()) { stop = true; break; }
+            improveCell(i, opt, st);
+        }
+        if (st.gain == before) break;
+    }
+    PDA_PROF_COUNT("swap.swaps", st.swaps);
+    PDA_PROF_COUNT("swap.moves", st.moves);
+    PDA_PROF_SAMPLE("swap.gain", st.gain);
+    return st;
+}
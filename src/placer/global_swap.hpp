@@ -0,0 +1,54 @@
+#pragma once
+#include "../core/deadline.hpp"
+#include "../core/netlist.hpp"
+#include "incremental_hpwl.hpp"
+#include "row_index.hpp"
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// Global swap (optimal region)
+// ==========================================
+// 對每個可動單元：
+//  1. 把它連到的每條 net 去掉自己後的 bounding box 邊界收集起來，
+//     x / y 各自取中位數區間，就是它單獨移動時 HPWL 最小的區域 (optimal region)
+//  2. 已經在區域內就跳過；否則用 RowIndex 只查區域內的同寬度單元 (交換)
+//     與夠寬的空隙 (直接移過去)
+//  3. 以 IncrementalHpwl 試算，取最好的一個負 delta commit
+// 每個單元的工作量只跟它的 net 大小與區域內的候選數有關，整體接近線性。
+struct GlobalSwapOptions {
+    int passes = 1;
+    int max_candidates = 48;   // 每個單元最多試幾個候選
+    int max_net_degree = 64;   // 更大的 net 不參與 optimal region 計算
+    core::Deadline deadline;   // 到期後停在目前的單元 (每步都是合法的 commit)
+};
+
+class GlobalSwap {
+public:
+    struct Stats {
+        long long gain = 0;
+        int swaps = 0;
+        int moves = 0;
+    };
+
+    GlobalSwap(core::Netlist& nl, RowIndex& index, IncrementalHpwl& inc)
+        : netlist(nl), index(index), inc(inc) {}
+
+    Stats run(const GlobalSwapOptions& opt);
+
+    // 單元 inst 的 optimal region；沒有可用的 net 時回傳 false
+    bool optimalRegion(int inst, int max_degree, int& xlo, int& xhi, int& ylo, int& yhi);
+
+private:
+    core::Netlist& netlist;
+    RowIndex& index;
+    IncrementalHpwl& inc;
+
+    // 暫存
+    vector<int> xs, ys;
+    vector<int> cands;
+    vector<RowIndex::Gap> gaps;
+
+    bool improveCell(int inst, const GlobalSwapOptions& opt, Stats& st);
+};
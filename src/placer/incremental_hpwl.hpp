@@ -0,0 +1,213 @@
+#pragma once
+#include "../core/netlist.hpp"
+#include "../core/hpwl.hpp"
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace std;
+
+// ==========================================
+// 增量式 HPWL 引擎
+// ==========================================
+// 每條 net 記住 bounding box 以及「落在四條邊界上的 pin 數」。
+// 移動 pin 時：
+//   - 往外移 / 留在框內       -> O(1) 更新邊界與計數
+//   - 邊界上最後一個 pin 往內移 -> 只有這時才重新掃描整條 net
+// 使用方式：delta_move / delta_swap / delta_moves 先試算 (不改座標)，
+// 滿意的話 commit() 把最後一次試算寫進 netlist 與 bounding box。
+class IncrementalHpwl {
+public:
+    struct Box {
+        int xmin, xmax, ymin, ymax;
+        int nxmin, nxmax, nymin, nymax; // 在各邊界上的 pin 數
+        long long hpwl() const { return (long long)(xmax - xmin) + (ymax - ymin); }
+    };
+
+    struct Move { int inst, x, y; };
+
+    core::Netlist& netlist;
+
+    explicit IncrementalHpwl(core::Netlist& nl) : netlist(nl) { rebuild(); }
+
+    // netlist 座標被外部改過 (例如 solveRegion) 之後要重建
+    void rebuild() {
+        const int nn = netlist.num_nets;
+        boxes.assign(nn, Box{});
+        net_stamp.assign(nn, 0);
+        node_stamp.assign(netlist.numNodes(), 0);
+        over_x.assign(netlist.numNodes(), 0);
+        over_y.assign(netlist.numNodes(), 0);
+        stamp = 1; // 與陣列初值 0 區隔
+        total_hpwl = 0;
+        for (int n = 0; n < nn; ++n) {
+            boxes[n] = scan(n);
+            total_hpwl += cost(n, boxes[n]);
+        }
+        clear_pending();
+    }
+
+    long long total() const { return total_hpwl; }
+    const Box& box(int net) const { return boxes[net]; }
+    long long net_cost(int net) const { return cost(net, boxes[net]); }
+
+    // 試算把 inst 移到 (x, y) 的 HPWL 變化量
+    long long delta_move(int inst, int x, int y) {
+        Move m{inst, x, y};
+        return delta_moves(&m, 1);
+    }
+
+    // 試算交換 a、b 兩個單元位置的 HPWL 變化量
+    long long delta_swap(int a, int b) {
+        if (a == b) return delta_moves(nullptr, 0);
+        Move m[2] = {{a, netlist.x[b], netlist.y[b]}, {b, netlist.x[a], netlist.y[a]}};
+        return delta_moves(m, 2);
+    }
+
+    // 試算一組同時發生的移動 (每個 inst 至多出現一次)
+    long long delta_moves(const Move* moves, int count) {
+        clear_pending();
+        next_stamp();
+        for (int i = 0; i < count; ++i) {
+            const Move& m = moves[i];
+            node_stamp[m.inst] = stamp;
+            over_x[m.inst] = m.x;
+            over_y[m.inst] = m.y;
+            pending_moves.push_back(m);
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int inst = moves[i].inst;
+            for (int k = netlist.instBegin(inst); k < netlist.instEnd(inst); ++k) {
+                int n = netlist.inst_nets[k];
+                if (net_stamp[n] == stamp) continue;
+                net_stamp[n] = stamp;
+                Box nb = update(n, moves, count);
+                pending_nets.push_back(n);
+                pending_boxes.push_back(nb);
+                pending_delta += cost(n, nb) - cost(n, boxes[n]);
+            }
+        }
+        return pending_delta;
+    }
+
+    long long delta_moves(const vector<Move>& moves) {
+        return delta_moves(moves.data(), (int)moves.size());
+    }
+
+    // 套用最後一次試算的結果
+    void commit() {
+        for (const Move& m : pending_moves) {
+            netlist.x[m.inst] = m.x;
+            netlist.y[m.inst] = m.y;
+        }
+        for (size_t i = 0; i < pending_nets.size(); ++i) {
+            boxes[pending_nets[i]] = pending_boxes[i];
+        }
+        total_hpwl += pending_delta;
+        clear_pending();
+        next_stamp(); // 讓 over_x / over_y 失效
+    }
+
+    // 除錯用：與 core::hpwl_counts 全量計算比對
+    bool verify() const { return total_hpwl == core::hpwl_counts(netlist); }
+
+private:
+    vector<Box> boxes;
+    long long total_hpwl = 0;
+
+    // 試算用的暫存：以 stamp 標記被覆寫座標的節點與已處理的 net
+    // 每次試算都會遞增，長時間執行會繞回；繞回時清空標記，避免舊標記被誤認
+    uint32_t stamp = 0;
+    vector<uint32_t> net_stamp, node_stamp;
+    vector<int> over_x, over_y;
+
+    vector<Move> pending_moves;
+    vector<int> pending_nets;
+    vector<Box> pending_boxes;
+    long long pending_delta = 0;
+
+    void clear_pending() {
+        pending_moves.clear();
+        pending_nets.clear();
+        pending_boxes.clear();
+        pending_delta = 0;
+    }
+
+    long long cost(int net, const Box& b) const {
+        return netlist.netDegree(net) == 0 ? 0 : b.hpwl();
+    }
+
+    void next_stamp() {
+        if (++stamp == 0) {
+            fill(net_stamp.begin(), net_stamp.end(), 0u);
+            fill(node_stamp.begin(), node_stamp.end(), 0u);
+            stamp = 1;
+        }
+    }
+
+    int px(int node) const { return node_stamp[node] == stamp ? over_x[node] : netlist.x[node]; }
+    int py(int node) const { return node_stamp[node] == stamp ? over_y[node] : netlist.y[node]; }
+
+    // 以 (試算中的) 座標完整掃描一條 net
+    Box scan(int net) const {
+        Box b{numeric_limits<int>::max(), numeric_limits<int>::min(),
+              numeric_limits<int>::max(), numeric_limits<int>::min(), 0, 0, 0, 0};
+        for (int k = netlist.netBegin(net); k < netlist.netEnd(net); ++k) {
+            int node = netlist.net_pins[k];
+            add_x(b, px(node));
+            add_y(b, py(node));
+        }
+        return b;
+    }
+
+    static void add_x(Box& b, int x) {
+        if (x < b.xmin) { b.xmin = x; b.nxmin = 1; } else if (x == b.xmin) ++b.nxmin;
+        if (x > b.xmax) { b.xmax = x; b.nxmax = 1; } else if (x == b.xmax) ++b.nxmax;
+    }
+    static void add_y(Box& b, int y) {
+        if (y < b.ymin) { b.ymin = y; b.nymin = 1; } else if (y == b.ymin) ++b.nymin;
+        if (y > b.ymax) { b.ymax = y; b.nymax = 1; } else if (y == b.ymax) ++b.nymax;
+    }
+
+    // 從舊 box 出發：先移除所有舊位置，再加入新位置。
+    // 某條邊界的計數歸零代表真正的邊界往內縮了，必須重掃。
+    Box update(int net, const Move* moves, int count) const {
+        Box b = boxes[net];
+        for_each_moved(net, moves, count, [&](int inst, int, int) {
+            int ox = netlist.x[inst], oy = netlist.y[inst];
+            if (ox == b.xmin) --b.nxmin;
+            if (ox == b.xmax) --b.nxmax;
+            if (oy == b.ymin) --b.nymin;
+            if (oy == b.ymax) --b.nymax;
+        });
+        for_each_moved(net, moves, count, [&](int, int x, int y) {
+            add_x(b, x);
+            add_y(b, y);
+        });
+        if (b.nxmin <= 0 || b.nxmax <= 0 || b.nymin <= 0 || b.nymax <= 0) return scan(net);
+        return b;
+    }
+
+    // 走訪 net 上被移動的 pin：移動數少時查 inst 的 net 清單，多時直接掃 net
+    template <class Fn>
+    void for_each_moved(int net, const Move* moves, int count, Fn fn) const {
+        if (count <= 8) {
+            for (int i = 0; i < count; ++i) {
+                if (on_net(net, moves[i].inst)) fn(moves[i].inst, moves[i].x, moves[i].y);
+            }
+        } else {
+            for (int k = netlist.netBegin(net); k < netlist.netEnd(net); ++k) {
+                int node = netlist.net_pins[k];
+                if (node_stamp[node] == stamp) fn(node, over_x[node], over_y[node]);
+            }
+        }
+    }
+
+    // inst 是否在 net 上：inst 的 net 清單已排序，二分搜尋
+    bool on_net(int net, int inst) const {
+        auto b = netlist.inst_nets.begin() + netlist.instBegin(inst);
+        auto e = netlist.inst_nets.begin() + netlist.instEnd(inst);
+        return binary_search(b, e, net);
+    }
+};
@@ -0,0 +1,221 @@
+#pragma once
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+// ==========================================
+// Dense Linear Assignment (Jonker–Volgenant 式最短增廣路 / Hungarian)
+// ==========================================
+// k 個 row (單元) 指派到 m 個 column (位置)，k <= m，每個 column 至多一個 row。
+// 直接在連續的 row-major 成本矩陣上做，複雜度 O(k^2 * m)，
+// 不需要建 source / sink 與 k*m 條邊的流網路。
+// 工作陣列在多次 solve 之間重複使用。
+//
+// warm start：給了初始指派 init 時，potential 取 row 最小值 (v = 0)，
+// init 中 reduced cost 為 0 (本身就是該 row 最便宜) 的邊直接保留，
+// 只有其餘的 row 需要找增廣路。已收斂的區域大多數 row 都不用動。
+class LinearAssignment {
+public:
+    // cost[i * m + j]：row i 放到 column j 的成本
+    // row_to_col[i]：回傳 row i 被指派到的 column
+    // init[i]：可選的初始指派 (例如目前的位置)，column 不可重複
+    // 回傳總成本
+    long long solve(const long long* cost, int k, int m, vector<int>& row_to_col, const int* init = nullptr) {
+        const long long INF = numeric_limits<long long>::max() / 4;
+        row_to_col.assign(k, -1);
+        if (k == 0) return 0;
+        PDA_PROF_COUNT("lap.solves", 1);
+
+        // 1-indexed：col_row[j] 是佔用 column j 的 row，0 表示空
+        u.assign(k + 1, 0);
+        v.assign(m + 1, 0);
+        col_row.assign(m + 1, 0);
+        row_col.assign(k + 1, 0);
+        way.assign(m + 1, 0);
+        minv.resize(m + 1);
+        used.resize(m + 1);
+        if (init) warm_start(cost, k, m, init);
+
+        for (int i = 1; i <= k; ++i) {
+            if (row_col[i] != 0) continue;  // warm start 已指派
+            // 以 row i 為起點，在 reduced cost 上做 Dijkstra 找增廣路
+            col_row[0] = i;
+            int j0 = 0;
+            fill(minv.begin(), minv.end(), INF);
+            fill(used.begin(), used.end(), 0);
+
+            do {
+                PDA_PROF_COUNT("lap.scans", 1);  // 每次 O(m) 的掃描
+                used[j0] = 1;
+                int i0 = col_row[j0], j1 = 0;
+                long long delta = INF;
+                const long long* row = cost + (long long)(i0 - 1) * m;
+                for (int j = 1; j <= m; ++j) {
+                    if (used[j]) continue;
+                    long long cur = row[j - 1] - u[i0] - v[j];
+                    if (cur < minv[j]) { minv[j] = cur; way[j] = j0; }
+                    if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+                }
+                for (int j = 0; j <= m; ++j) {
+                    if (used[j]) { u[col_row[j]] += delta; v[j] -= delta; }
+                    else minv[j] -= delta;
+                }
+                j0 = j1;
+            } while (col_row[j0] != 0);
+
+            // 沿著 way 反向翻轉增廣路
+            do {
+                int j1 = way[j0];
+                col_row[j0] = col_row[j1];
+                j0 = j1;
+            } while (j0 != 0);
+        }
+
+        long long total = 0;
+        for (int j = 1; j <= m; ++j) {
+            if (col_row[j] != 0) {
+                row_to_col[col_row[j] - 1] = j - 1;
+                total += cost[(long long)(col_row[j] - 1) * m + (j - 1)];
+            }
+        }
+        return total;
+    }
+
+private:
+    vector<long long> u, v, minv;
+    vector<int> col_row, row_col, way;
+    vector<char> used;
+
+    // u[i] = row 最小成本，init 中 tight 的邊直接配對 (1-indexed，與 solve 相同)
+    void warm_start(const long long* cost, int k, int m, const int* init) {
+        for (int i = 1; i <= k; ++i) {
+            const long long* row = cost + (long long)(i - 1) * m;
+            u[i] = *min_element(row, row + m);
+            const int j = init[i - 1] + 1;
+            if (j >= 1 && j <= m && col_row[j] == 0 && row[j - 1] == u[i]) {
+                col_row[j] = i;
+                row_col[i] = j;
+            }
+        }
+        PDA_PROF_COUNT("lap.warm_rows", count_if(row_col.begin() + 1, row_col.end(), [](int j) { return j != 0; }));
+    }
+};
+
+// ==========================================
+// Sparse Linear Assignment (同樣是最短增廣路，只走給定的邊)
+// ==========================================
+// 每個 row 只有少數候選 column (CSR)。逐一加入 row，以 row / column potential
+// 上的 Dijkstra (binary heap) 找到最近的空 column 再沿路翻轉；
+// 只碰到被走到的 column，通常遠小於整張圖。
+// 複雜度最差 O(k * E log m)，E 為邊數；不可行 (沒有完美匹配) 時回傳 false。
+// init 的 warm start 與 LinearAssignment 相同 (init 的邊不在候選裡就忽略)。
+class SparseAssignment {
+public:
+    // row i 的候選 column 為 col[start[i] .. start[i + 1])，成本 cost[同位置]
+    bool solve(const int* start, const int* col, const long long* cost, int k, int m, vector<int>& row_to_col,
+               const int* init = nullptr) {
+        const long long INF = numeric_limits<long long>::max() / 4;
+        row_to_col.assign(k, -1);
+        if (k == 0) return true;
+        PDA_PROF_COUNT("lap.sparse_solves", 1);
+
+        // 初始 potential：u[i] = row 最小成本，v = 0，reduced cost 皆非負
+        u.assign(k, 0);
+        v.assign(m, 0);
+        col_row.assign(m, -1);
+        dist.assign(m, INF);
+        pred.assign(m, -1);
+        state.assign(m, 0);
+        for (int i = 0; i < k; ++i) {
+            long long lo = INF;
+            for (int e = start[i]; e < start[i + 1]; ++e) lo = min(lo, cost[e]);
+            u[i] = lo == INF ? 0 : lo;
+        }
+        if (init) {
+            long long warm = 0;
+            for (int i = 0; i < k; ++i) {
+                const int j = init[i];
+                if (j < 0 || j >= m || col_row[j] >= 0) continue;
+                for (int e = start[i]; e < start[i + 1]; ++e) {
+                    if (col[e] == j && cost[e] == u[i]) {
+                        col_row[j] = i;
+                        row_to_col[i] = j;
+                        ++warm;
+                        break;
+                    }
+                }
+            }
+            PDA_PROF_COUNT("lap.warm_rows", warm);
+        }
+
+        auto cmp = [](const pair<long long, int>& a, const pair<long long, int>& b) { return a.first > b.first; };
+        for (int i0 = 0; i0 < k; ++i0) {
+            if (row_to_col[i0] >= 0) continue;  // warm start 已指派
+            // row 的距離 = 走到它所配對 column 的距離；起點 row i0 為 0
+            heap.clear();
+            touched.clear();
+            int sink = -1;
+            long long D = 0;
+            auto relax = [&](int r, long long dr) {
+                for (int e = start[r]; e < start[r + 1]; ++e) {
+                    int j = col[e];
+                    if (state[j] == 2) continue;
+                    long long nd = dr + cost[e] - u[r] - v[j];
+                    if (nd < dist[j]) {
+                        if (state[j] == 0) { state[j] = 1; touched.push_back(j); }
+                        dist[j] = nd;
+                        pred[j] = r;
+                        heap.push_back({nd, j});
+                        push_heap(heap.begin(), heap.end(), cmp);
+                    }
+                }
+            };
+            relax(i0, 0);
+            while (!heap.empty()) {
+                pop_heap(heap.begin(), heap.end(), cmp);
+                auto [d, j] = heap.back();
+                heap.pop_back();
+                if (state[j] == 2 || d != dist[j]) continue;
+                state[j] = 2;
+                PDA_PROF_COUNT("lap.sparse_scans", 1);
+                if (col_row[j] < 0) { sink = j; D = d; break; }
+                relax(col_row[j], d);
+            }
+            if (sink < 0) {
+                row_to_col.assign(k, -1);
+                return false;
+            }
+
+            // potential 更新：定案的 column / row 依與 D 的差距調整，路徑上的邊變成 tight
+            u[i0] += D;
+            for (int j : touched) {
+                if (state[j] == 2 && j != sink) {
+                    v[j] -= D - dist[j];
+                    u[col_row[j]] += D - dist[j];
+                }
+            }
+
+            // 沿 pred 翻轉增廣路
+            for (int j = sink; j >= 0; ) {
+                int r = pred[j];
+                int next = r == i0 ? -1 : row_to_col[r];
+                col_row[j] = r;
+                row_to_col[r] = j;
+                j = next;
+            }
+
+            for (int j : touched) { dist[j] = INF; state[j] = 0; pred[j] = -1; }
+        }
+        return true;
+    }
+
+private:
+    vector<long long> u, v, dist;
+    vector<int> col_row, pred, touched;
+    vector<char> state;   // 0 未碰到 / 1 在 heap 中 / 2 已定案
+    vector<pair<long long, int>> heap;
+};
@@ -0,0 +1,204 @@
+#pragma once
+#include "../core/profiler.hpp"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+// ==========================================
+// Min-Cost Max-Flow (MCMF) Solver
+// ==========================================
+// Successive shortest path + Johnson potentials：
+//  - 殘餘圖以 CSR 存放，每條弧只有 to / rev / cap 三個 int，cost 另外一個陣列 (SoA)
+//  - 有了 potential 之後 reduced cost 皆非負，每輪用 binary heap 的 Dijkstra
+//  - 若有負成本邊，第一次先用 Bellman-Ford 求初始 potential
+//  - reset() 只清內容不釋放記憶體，同一個物件可反覆拿來解不同的圖
+class MinCostMaxFlow {
+public:
+    int n = 0;
+    int s = 0, t = 0;
+
+    MinCostMaxFlow() = default;
+    MinCostMaxFlow(int num_nodes, int source, int sink) { reset(num_nodes, source, sink); }
+
+    void reset(int num_nodes, int source, int sink) {
+        n = num_nodes;
+        s = source;
+        t = sink;
+        edge_u.clear();
+        edge_v.clear();
+        edge_cap.clear();
+        edge_cost.clear();
+        built = false;
+    }
+
+    // 回傳邊的 ID，之後可用 flow(id) 查詢流量
+    int add_edge(int u, int v, int cap, long long cost) {
+        edge_u.push_back(u);
+        edge_v.push_back(v);
+        edge_cap.push_back(cap);
+        edge_cost.push_back(cost);
+        built = false;
+        return (int)edge_u.size() - 1;
+    }
+
+    int num_edges() const { return (int)edge_u.size(); }
+
+    // 邊 id 上的流量 (= 反向弧的殘餘容量)
+    int flow(int id) const { return arc_cap[arc_rev[edge_arc[id]]]; }
+
+    pair<int, long long> solve(int max_flow = numeric_limits<int>::max()) {
+        build();
+        int total_flow = 0;
+        long long total_cost = 0;
+
+        if (!init_potential()) return {0, 0};
+        [[maybe_unused]] const long long rounds0 = dijkstra_rounds, relaxed0 = relaxed_arcs;
+
+        while (total_flow < max_flow && dijkstra()) {
+            // 沿最短路找瓶頸容量
+            int push = max_flow - total_flow;
+            for (int v = t; v != s; v = arc_to[arc_rev[parent_arc[v]]]) {
+                push = min(push, arc_cap[parent_arc[v]]);
+            }
+            for (int v = t; v != s; ) {
+                int a = parent_arc[v];
+                arc_cap[a] -= push;
+                arc_cap[arc_rev[a]] += push;
+                total_cost += (long long)push * arc_cost[a];
+                v = arc_to[arc_rev[a]];
+            }
+            total_flow += push;
+        }
+        PDA_PROF_COUNT("mcmf.solves", 1);
+        PDA_PROF_COUNT("mcmf.sp_rounds", dijkstra_rounds - rounds0);
+        PDA_PROF_COUNT("mcmf.relaxed_arcs", relaxed_arcs - relaxed0);
+        return {total_flow, total_cost};
+    }
+
+    // 累計統計 (除錯 / profiling 用)
+    long long dijkstra_rounds = 0;
+    long long relaxed_arcs = 0;
+
+private:
+    static constexpr long long INF = numeric_limits<long long>::max() / 4;
+
+    // 加邊時的暫存 (edge list)
+    vector<int> edge_u, edge_v, edge_cap;
+    vector<long long> edge_cost;
+    bool built = false;
+
+    // CSR 殘餘圖
+    vector<int> head;         // 大小 n + 1
+    vector<int> arc_to, arc_rev, arc_cap;
+    vector<long long> arc_cost;
+    vector<int> edge_arc;     // 邊 id -> 正向弧位置
+
+    // 工作陣列，跨 solve 重複使用
+    vector<long long> dist, potential;
+    vector<int> parent_arc;
+    vector<char> done;
+    vector<pair<long long, int>> heap;
+
+    void build() {
+        if (built) return;
+        const int m = (int)edge_u.size();
+        head.assign(n + 1, 0);
+        for (int e = 0; e < m; ++e) {
+            ++head[edge_u[e] + 1];
+            ++head[edge_v[e] + 1];
+        }
+        for (int v = 0; v < n; ++v) head[v + 1] += head[v];
+
+        arc_to.resize(2 * m);
+        arc_rev.resize(2 * m);
+        arc_cap.resize(2 * m);
+        arc_cost.resize(2 * m);
+        edge_arc.resize(m);
+
+        vector<int>& fill_pos = parent_arc; // 借用工作陣列
+        fill_pos.assign(head.begin(), head.end() - 1);
+        for (int e = 0; e < m; ++e) {
+            int a = fill_pos[edge_u[e]]++;
+            int b = fill_pos[edge_v[e]]++;
+            arc_to[a] = edge_v[e]; arc_rev[a] = b; arc_cap[a] = edge_cap[e]; arc_cost[a] = edge_cost[e];
+            arc_to[b] = edge_u[e]; arc_rev[b] = a; arc_cap[b] = 0;           arc_cost[b] = -edge_cost[e];
+            edge_arc[e] = a;
+        }
+
+        dist.resize(n);
+        potential.resize(n);
+        parent_arc.assign(n, -1);
+        done.resize(n);
+        built = true;
+    }
+
+    // 全部成本非負時 potential = 0；否則以 Bellman-Ford 求 s 出發的最短距離
+    bool init_potential() {
+        fill(potential.begin(), potential.end(), 0);
+        bool negative = false;
+        for (long long c : edge_cost) negative |= (c < 0);
+        if (!negative) return true;
+
+        fill(dist.begin(), dist.end(), INF);
+        dist[s] = 0;
+        for (int iter = 0; iter < n; ++iter) {
+            bool changed = false;
+            for (int u = 0; u < n; ++u) {
+                if (dist[u] == INF) continue;
+                for (int a = head[u]; a < head[u + 1]; ++a) {
+                    if (arc_cap[a] > 0 && dist[u] + arc_cost[a] < dist[arc_to[a]]) {
+                        dist[arc_to[a]] = dist[u] + arc_cost[a];
+                        changed = true;
+                    }
+                }
+            }
+            if (!changed) break;
+            if (iter == n - 1) return false; // 負環
+        }
+        for (int v = 0; v < n; ++v) potential[v] = dist[v] == INF ? 0 : dist[v];
+        return true;
+    }
+
+    // reduced cost (cost + p[u] - p[v]) 上的 Dijkstra
+    bool dijkstra() {
+        ++dijkstra_rounds;
+        fill(dist.begin(), dist.end(), INF);
+        fill(done.begin(), done.end(), 0);
+        heap.clear();
+        auto cmp = [](const pair<long long, int>& a, const pair<long long, int>& b) { return a.first > b.first; };
+
+        dist[s] = 0;
+        heap.push_back({0, s});
+        while (!heap.empty()) {
+            pop_heap(heap.begin(), heap.end(), cmp);
+            auto [d, u] = heap.back();
+            heap.pop_back();
+            if (done[u]) continue;
+            done[u] = 1;
+            if (u == t) break; // 比 t 遠的節點不影響這一輪
+
+            for (int a = head[u]; a < head[u + 1]; ++a) {
+                if (arc_cap[a] <= 0) continue;
+                int v = arc_to[a];
+                long long nd = d + arc_cost[a] + potential[u] - potential[v];
+                ++relaxed_arcs;
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    parent_arc[v] = a;
+                    heap.push_back({nd, v});
+                    push_heap(heap.begin(), heap.end(), cmp);
+                }
+            }
+        }
+        if (!done[t]) return false;
+
+        // potential += min(dist, dist[t])：未定案的節點一律加 dist[t]，
+        // 可保證所有殘餘弧的 reduced cost 仍非負
+        const long long D = dist[t];
+        for (int v = 0; v < n; ++v) potential[v] += done[v] ? dist[v] : D;
+        return true;
+    }
+};
@@ -0,0 +1,214 @@
+#include "row_index.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+void RowIndex::build(const core::Design& d, const core::Netlist& nl) {
+    PDA_PROF_SCOPE("build.row_index");
+    netlist = &nl;
+
+    // 1. row 依 y 排序；同一個 y 的多段 ROW 各自成為一個 segment，
+    //    相接 (或重疊) 且 site 寬度與格點相同的段才合併
+    rows.clear();
+    vector<const core::Row*> src;
+    for (const auto& r : d.rows) src.push_back(&r);
+    sort(src.begin(), src.end(), [](const core::Row* a, const core::Row* b) {
+        return a->y0 != b->y0 ? a->y0 < b->y0 : a->x0 < b->x0;
+    });
+    for (const core::Row* r : src) {
+        Segment sg;
+        sg.step = max(1, r->step_x);
+        sg.x0 = r->x0;
+        sg.x1 = r->x0 + max(1, r->nx) * sg.step;
+        if (!rows.empty() && rows.back().y == r->y0) {
+            Row& row = rows.back();
+            Segment& last = row.segs.back();
+            if (sg.x0 <= last.x1 && sg.step == last.step && (sg.x0 - last.x0) % last.step == 0) {
+                last.x1 = max(last.x1, sg.x1);
+            } else {
+                // 與前一段重疊但格點不同：重疊的部分歸前一段
+                sg.x0 = max(sg.x0, last.x1);
+                if (sg.x0 < sg.x1) row.segs.push_back(sg);
+            }
+            row.x1 = max(row.x1, sg.x1);
+            continue;
+        }
+        Row row;
+        row.y = r->y0;
+        row.x0 = sg.x0;
+        row.x1 = sg.x1;
+        row.step = sg.step;
+        row.segs.push_back(sg);
+        row.orient = r->orient;
+        const core::Site* site = d.sites.find(r->site);
+        row.height = site ? site->h_dbu : 0;
+        rows.push_back(std::move(row));
+    }
+    for (size_t r = 0; r < rows.size(); ++r) {
+        if (rows[r].height > 0) continue;
+        rows[r].height = r + 1 < rows.size() ? rows[r + 1].y - rows[r].y : (r > 0 ? rows[r].y - rows[r - 1].y : 1);
+    }
+
+    // 2. 單元登記到它蓋到的每一條 row
+    inst_row.assign(nl.num_insts, -1);
+    inst_x.assign(nl.num_insts, 0);
+    bad_width = 0;
+    for (int i = 0; i < nl.num_insts; ++i) {
+        if (nl.width[i] <= 0) continue;
+        int ylo = nl.y[i], yhi = nl.y[i] + max(1, nl.height[i]);
+        auto it = lower_bound(rows.begin(), rows.end(), ylo, [](const Row& r, int y) { return r.y + r.height <= y; });
+        for (; it != rows.end() && it->y < yhi; ++it) {
+            int r = int(it - rows.begin());
+            if (inst_row[i] < 0) inst_row[i] = r;
+            insert(r, i, nl.x[i]);
+        }
+        inst_x[i] = nl.x[i];
+        if (inst_row[i] >= 0) {
+            const Row& row = rows[inst_row[i]];
+            const int s = segmentAt(inst_row[i], nl.x[i]);
+            if (nl.width[i] % (s >= 0 ? row.segs[s].step : row.step) != 0) ++bad_width;
+        }
+    }
+    if (bad_width > 0) {
+        cerr << "[WARN] " << bad_width << " instances have widths that are not a multiple of the site width\n";
+    }
+}
+
+int RowIndex::rowOf(int y) const {
+    auto it = lower_bound(rows.begin(), rows.end(), y, [](const Row& r, int v) { return r.y < v; });
+    if (it == rows.end() || it->y != y) return -1;
+    return int(it - rows.begin());
+}
+
+int RowIndex::nearestRow(int y) const {
+    if (rows.empty()) return -1;
+    auto it = upper_bound(rows.begin(), rows.end(), y, [](int v, const Row& r) { return v < r.y; });
+    if (it == rows.begin()) return 0;
+    return int(it - rows.begin()) - 1;
+}
+
+void RowIndex::insert(int r, int inst, int x) {
+    rows[r].cells.insert({x, inst});
+    rows[r].max_width = max(rows[r].max_width, width(inst));
+}
+
+void RowIndex::erase(int r, int inst, int x) {
+    rows[r].cells.erase({x, inst});
+}
+
+void RowIndex::cellsIn(int r0, int r1, int xl, int xr, vector<int>& out) const {
+    size_t first = out.size();
+    r0 = max(r0, 0);
+    r1 = min(r1, numRows() - 1);
+    for (int r = r0; r <= r1; ++r) {
+        const Row& row = rows[r];
+        // 左邊界以左 max_width 內開始的單元仍可能蓋進視窗
+        for (auto it = row.cells.lower_bound({xl - row.max_width + 1, -1});
+             it != row.cells.end() && it->first < xr; ++it) {
+            if (it->first + width(it->second) > xl) out.push_back(it->second);
+        }
+    }
+    // 多 row macro 會在每條 row 各出現一次
+    if (r1 > r0) {
+        sort(out.begin() + first, out.end());
+        out.erase(unique(out.begin() + first, out.end()), out.end());
+    }
+}
+
+void RowIndex::freeGaps(int r, int xl, int xr, int min_w, vector<Gap>& out) const {
+    const Row& row = rows[r];
+    for (int s = 0; s < (int)row.segs.size(); ++s) {
+        const Segment& sg = row.segs[s];
+        const int lo = max(xl, sg.x0), hi = min(xr, sg.x1);
+        if (lo >= hi) continue;
+
+        // 從蓋住 lo 的最後一個單元的右緣開始走
+        int cur = lo;
+        auto it = row.cells.lower_bound({lo - row.max_width + 1, -1});
+        for (; it != row.cells.end() && it->first < hi; ++it) {
+            int cx = it->first, cr = cx + width(it->second);
+            if (cx > cur && min(cx, hi) - cur >= min_w) out.push_back({r, cur, min(cx, hi), s});
+            cur = max(cur, cr);
+            if (cur >= hi) break;
+        }
+        if (hi - cur >= min_w) out.push_back({r, cur, hi, s});
+    }
+}
+
+int RowIndex::leftOf(int inst) const {
+    int r = inst_row[inst];
+    if (r < 0) return -1;
+    const auto& cells = rows[r].cells;
+    auto it = cells.find({inst_x[inst], inst});
+    if (it == cells.begin()) return -1;
+    return prev(it)->second;
+}
+
+int RowIndex::rightOf(int inst) const {
+    int r = inst_row[inst];
+    if (r < 0) return -1;
+    const auto& cells = rows[r].cells;
+    auto it = cells.find({inst_x[inst], inst});
+    if (it == cells.end() || next(it) == cells.end()) return -1;
+    return next(it)->second;
+}
+
+int RowIndex::segmentAt(int r, int x) const {
+    const vector<Segment>& segs = rows[r].segs;
+    auto it = upper_bound(segs.begin(), segs.end(), x, [](int v, const Segment& sg) { return v < sg.x0; });
+    if (it == segs.begin() || x >= prev(it)->x1) return -1;
+    return int(prev(it) - segs.begin());
+}
+
+bool RowIndex::onGrid(int r, int x, int w) const {
+    if (r < 0 || r >= numRows()) return false;
+    const int s = segmentAt(r, x);
+    if (s < 0) return false;
+    const Segment& sg = rows[r].segs[s];
+    return x + w <= sg.x1 && (x - sg.x0) % sg.step == 0;
+}
+
+bool RowIndex::isFree(int r, int x, int w, int ignore) const {
+    if (!onGrid(r, x, w)) return false;
+    const Row& row = rows[r];
+    for (auto it = row.cells.lower_bound({x - row.max_width + 1, -1});
+         it != row.cells.end() && it->first < x + w; ++it) {
+        if (it->second != ignore && it->first + width(it->second) > x) return false;
+    }
+    return true;
+}
+
+void RowIndex::move(int inst, int x, int y) {
+    int r = rowOf(y);
+    if (inst_row[inst] >= 0) erase(inst_row[inst], inst, inst_x[inst]);
+    inst_row[inst] = r;
+    inst_x[inst] = x;
+    if (r >= 0) insert(r, inst, x);
+}
+
+int RowIndex::violations(vector<int>* bad) const {
+    vector<char> flagged(inst_row.size(), 0);
+    for (int r = 0; r < numRows(); ++r) {
+        const Row& row = rows[r];
+        int reach = numeric_limits<int>::min(), reach_inst = -1; // 目前為止單元右緣的最大值
+        for (const auto& [x, inst] : row.cells) {
+            int w = width(inst);
+            bool fixed = netlist->fixed[inst];
+            // FIXED 的 macro 不受 row 範圍 / site 對齊限制
+            if (!fixed && !onGrid(r, x, w)) flagged[inst] = 1;
+            if (x < reach) {
+                flagged[inst] = 1;
+                if (reach_inst >= 0) flagged[reach_inst] = 1;
+            }
+            if (x + w > reach) { reach = x + w; reach_inst = inst; }
+        }
+    }
+    int count = 0;
+    for (size_t i = 0; i < flagged.size(); ++i) {
+        if (!flagged[i]) continue;
+        ++count;
+        if (bad) bad->push_back((int)i);
+    }
+    return count;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "../core/design.hpp"
+#include "../core/netlist.hpp"
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// Row 佔用索引
+// ==========================================
+// 每條 row 一個依 x 排序的 set<(x, inst)>，FIXED 單元也在裡面 (跨多條 row 的
+// macro 會登記在每一條它蓋到的 row)。空隙不另外存：兩個相鄰單元之間就是空隙，
+// 所以移動單元只要 erase + insert，空隙自然跟著更新。
+// 同一個 y 可以有多段 ROW (中間有空缺、或 site 原點不同)，各段保留自己的範圍與格點；
+// 段與段之間的空缺不可放置。
+//   - 視窗內的單元 / 空隙、單元的左右鄰居：O(log n + 結果數)
+//   - 移動單元：O(log n)
+// 索引只記位置，不會改 netlist 的座標；呼叫端移動單元時兩邊都要更新。
+class RowIndex {
+public:
+    struct Segment {
+        int x0 = 0, x1 = 0;   // 可放置範圍 [x0, x1)
+        int step = 1;         // site 寬度，格點為 x0 + k * step
+    };
+
+    struct Row {
+        int y = 0, height = 0;
+        int x0 = 0, x1 = 0;   // 所有 segment 的外框
+        int step = 1;         // 第一段的 site 寬度 (各段自己的在 segs)
+        vector<Segment> segs;  // 依 x0 排序、互不重疊；相鄰且格點相同的段已合併
+        core::Orient orient = core::Orient::N;
+        set<pair<int, int>> cells; // (x, inst)
+        int max_width = 0;         // row 上最寬單元，用來界定往左找的範圍
+    };
+
+    struct Gap {
+        int row, x0, x1;
+        int seg;              // 所在的 segment (空隙不會跨段)
+        int width() const { return x1 - x0; }
+    };
+
+    void build(const core::Design& d, const core::Netlist& nl);
+
+    int numRows() const { return (int)rows.size(); }
+    const Row& row(int r) const { return rows[r]; }
+
+    // y 正好是某條 row 原點的 row 索引，否則 -1
+    int rowOf(int y) const;
+    // 包含 y 的 row (超出範圍時夾到最上 / 最下那條；沒有 row 時為 -1)
+    int nearestRow(int y) const;
+    // 單元目前所在的 row (多 row 的 macro 為最下面那條；不在任何 row 上為 -1)
+    int rowOfInst(int inst) const { return inst_row[inst]; }
+
+    // row [r0, r1] 中與 [xl, xr) 有交集的單元 (同一單元只出現一次)
+    void cellsIn(int r0, int r1, int xl, int xr, vector<int>& out) const;
+
+    // row r 在 [xl, xr) 內寬度 >= min_w 的空隙 (已截到查詢範圍與 segment 內)
+    void freeGaps(int r, int xl, int xr, int min_w, vector<Gap>& out) const;
+
+    // 同一 row 上緊鄰的左 / 右單元，沒有則 -1
+    int leftOf(int inst) const;
+    int rightOf(int inst) const;
+
+    // row r 上包含 x 的 segment，沒有則 -1
+    int segmentAt(int r, int x) const;
+    // [x, x + w) 是否整段落在 row r 的同一個 segment 內且對齊該段的 site
+    bool onGrid(int r, int x, int w) const;
+
+    // [x, x + w) 放在 row r 是否 onGrid 且不與其他單元重疊 (忽略 ignore)
+    bool isFree(int r, int x, int w, int ignore = -1) const;
+
+    // 把單一 row 高度的可動單元移到 (x, y)；y 必須是某條 row 的原點
+    void move(int inst, int x, int y);
+
+    // 檢查整體合法性：越界、未對齊 site、重疊。回傳違規單元數
+    int violations(vector<int>* bad = nullptr) const;
+
+    // 寬度不是 site 寬度整數倍的單元數 (build 時統計)
+    int misalignedWidths() const { return bad_width; }
+
+private:
+    const core::Netlist* netlist = nullptr;
+    vector<Row> rows;            // 依 y 排序
+    vector<int> inst_row;        // 單元 -> row (-1 表示不在 row 上)
+    vector<int> inst_x;          // 單元在索引中的 x
+    int bad_width = 0;
+
+    int width(int inst) const { return netlist->width[inst]; }
+    void insert(int r, int inst, int x);
+    void erase(int r, int inst, int x);
+};
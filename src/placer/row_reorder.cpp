@@ -0,0 +1,214 @@
+#include "row_reorder.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+
+RowReorder::RowReorder(core::Netlist& nl, const RowIndex& index, core::ThreadPool& pool)
+    : netlist(nl), index(index), pool(pool) {
+    workspaces.resize(pool.size());
+    for (auto& ws : workspaces) ws.mark.assign(nl.num_insts, 0);
+}
+
+// 從 RowIndex 取出各 row 的單元，找出 k 個連續且都可動 (單一 row 高、在 row 原點上) 的位置；
+// 視窗不跨 ROW segment，否則重排後的單元可能落到段與段之間的空缺
+void RowReorder::collect(int k) {
+    const int R = index.numRows();
+    row_cells.assign(R, {});
+    row_starts.assign(R, {});
+    for (int r = 0; r < R; ++r) {
+        const RowIndex::Row& row = index.row(r);
+        auto& cells = row_cells[r];
+        for (const auto& [x, inst] : row.cells) cells.push_back(inst);
+
+        int run = 0; // 以 i 結尾的連續可動單元數
+        int run_seg = -1;
+        for (int i = 0; i < (int)cells.size(); ++i) {
+            int c = cells[i];
+            bool movable = !netlist.fixed[c] && netlist.y[c] == row.y && netlist.height[c] <= row.height &&
+                           index.onGrid(r, netlist.x[c], netlist.width[c]);
+            // 與前一個單元重疊 (不合法的輸入) 或在不同 segment 時不要跨過去
+            const int sg = movable ? index.segmentAt(r, netlist.x[c]) : -1;
+            if (movable && run > 0) {
+                int p = cells[i - 1];
+                if (netlist.x[p] + netlist.width[p] > netlist.x[c] || sg != run_seg) run = 0;
+            }
+            run_seg = sg;
+            run = movable ? run + 1 : 0;
+            if (run >= k) row_starts[r].push_back(i - k + 1);
+        }
+    }
+}
+
+void RowReorder::dfs(Workspace& ws, int depth, int x, long long partial) {
+    if (partial >= ws.best) return; // box 只會變大，partial 是下界
+    if (depth == ws.k) {
+        ws.best = partial;
+        ws.best_order = ws.order;
+        return;
+    }
+    for (int c = 0; c < ws.k; ++c) {
+        if (ws.used[c]) continue;
+        ws.used[c] = 1;
+        ws.order[depth] = c;
+
+        size_t mark = ws.saved.size();
+        long long np = partial;
+        for (int q = ws.cell_net_start[c]; q < ws.cell_net_start[c + 1]; ++q) {
+            int ln = ws.cell_nets[q];
+            Box& b = ws.box[ln];
+            ws.saved.push_back({ln, b});
+            long long old = b.hpwl();
+            b.add(x, ws.y);
+            np += b.hpwl() - old;
+        }
+        dfs(ws, depth + 1, x + ws.width[c] + ws.gap[depth], np);
+
+        while (ws.saved.size() > mark) {
+            ws.box[ws.saved.back().first] = ws.saved.back().second;
+            ws.saved.pop_back();
+        }
+        ws.used[c] = 0;
+    }
+}
+
+long long RowReorder::reorderWindow(Workspace& ws, int* cells, int k) {
+    ws.k = k;
+    ws.y = netlist.y[cells[0]];
+    ws.cells.assign(cells, cells + k);
+    ws.width.resize(k);
+    ws.gap.assign(k, 0);
+    for (int i = 0; i < k; ++i) ws.width[i] = netlist.width[cells[i]];
+    for (int i = 0; i + 1 < k; ++i) ws.gap[i] = netlist.x[cells[i + 1]] - (netlist.x[cells[i]] + ws.width[i]);
+    const int x0 = netlist.x[cells[0]];
+
+    // 1. 局部 net 與外部 pin 的 bounding box；固定的 net 直接用這一輪開始時的 box
+    //    (含視窗內的單元，不讀其他視窗正在寫的座標)
+    ++ws.stamp;
+    for (int c : ws.cells) ws.mark[c] = ws.stamp;
+    ws.nets.clear();
+    for (int c : ws.cells) {
+        ws.nets.insert(ws.nets.end(), netlist.inst_nets.begin() + netlist.instBegin(c),
+                       netlist.inst_nets.begin() + netlist.instEnd(c));
+    }
+    sort(ws.nets.begin(), ws.nets.end());
+    ws.nets.erase(unique(ws.nets.begin(), ws.nets.end()), ws.nets.end());
+
+    ws.box.assign(ws.nets.size(), Box{});
+    const FrozenNets& frozen = scheduler.frozen();
+    long long base = 0;
+    for (size_t ln = 0; ln < ws.nets.size(); ++ln) {
+        int n = ws.nets[ln];
+        if (frozen.frozen(netlist, n)) {
+            const FrozenNets::Box& b = frozen.box[n];
+            ws.box[ln].add(b.xmin, b.ymin);
+            ws.box[ln].add(b.xmax, b.ymax);
+            base += ws.box[ln].hpwl();
+            continue;
+        }
+        for (int q = netlist.netBegin(n); q < netlist.netEnd(n); ++q) {
+            int node = netlist.net_pins[q];
+            if (node < netlist.num_insts && ws.mark[node] == ws.stamp) continue;
+            ws.box[ln].add(netlist.x[node], netlist.y[node]);
+        }
+        base += ws.box[ln].hpwl();
+    }
+
+    ws.cell_net_start.assign(1, 0);
+    ws.cell_nets.clear();
+    for (int c : ws.cells) {
+        for (int q = netlist.instBegin(c); q < netlist.instEnd(c); ++q) {
+            int n = netlist.inst_nets[q];
+            ws.cell_nets.push_back(int(lower_bound(ws.nets.begin(), ws.nets.end(), n) - ws.nets.begin()));
+        }
+        ws.cell_net_start.push_back((int)ws.cell_nets.size());
+    }
+
+    // 2. 目前順序的成本當作初始上界 (只接受嚴格變好的排列)
+    long long current = 0;
+    {
+        vector<Box> b = ws.box;
+        int x = x0;
+        for (int i = 0; i < k; ++i) {
+            for (int q = ws.cell_net_start[i]; q < ws.cell_net_start[i + 1]; ++q) b[ws.cell_nets[q]].add(x, ws.y);
+            x += ws.width[i] + ws.gap[i];
+        }
+        for (const Box& bx : b) current += bx.hpwl();
+    }
+
+    ws.best = current;
+    ws.order.assign(k, 0);
+    ws.best_order.clear();
+    ws.used.assign(k, 0);
+    ws.saved.clear();
+    dfs(ws, 0, x0, base);
+    if (ws.best_order.empty()) return 0;
+
+    // 3. 套用：依新順序重新排出座標，並把 row_cells 裡的順序一起更新
+    int x = x0;
+    for (int i = 0; i < k; ++i) {
+        int c = ws.cells[ws.best_order[i]];
+        netlist.x[c] = x;
+        cells[i] = c;
+        x += netlist.width[c] + ws.gap[i];
+    }
+    return current - ws.best;
+}
+
+RowReorder::Stats RowReorder::run(const ReorderOptions& opt) {
+    PDA_PROF_SCOPE("opt.reorder");
+    Stats st;
+    const int k = max(2, min(opt.window, 8));
+    collect(k);
+
+    int rounds = 0;
+    for (const auto& s : row_starts) rounds = max(rounds, (int)s.size());
+
+    vector<int> win_start, win_cells, win_row, win_pos;
+    vector<long long> win_gain;
+    bool stop = false;
+    for (int p = 0; p < opt.passes && !stop; ++p) {
+        long long before = st.gain;
+        for (int t = 0; t < rounds; ++t) {
+            if (opt.deadline.expired()) { stop = true; break; }
+            // 這一輪的視窗：每條 row 的第 t 個
+            win_start.assign(1, 0);
+            win_cells.clear();
+            win_row.clear();
+            win_pos.clear();
+            for (int r = 0; r < (int)row_starts.size(); ++r) {
+                if (t >= (int)row_starts[r].size()) continue;
+                int s = row_starts[r][t];
+                win_cells.insert(win_cells.end(), row_cells[r].begin() + s, row_cells[r].begin() + s + k);
+                win_start.push_back((int)win_cells.size());
+                win_row.push_back(r);
+                win_pos.push_back(s);
+            }
+            const int nw = (int)win_row.size();
+            scheduler.max_net_degree = opt.max_net_degree;
+            scheduler.build(netlist, win_start, win_cells);
+            win_gain.assign(nw, 0);
+
+            const vector<int>& order = scheduler.order();
+            for (int bt = 0; bt < scheduler.numBatches(); ++bt) {
+                const int base = scheduler.batchBegin(bt);
+                pool.parallel_for(scheduler.batchSize(bt), 1, [&](int b, int e, int tid) {
+                    for (int q = b; q < e; ++q) {
+                        int w = order[base + q];
+                        win_gain[w] = reorderWindow(workspaces[tid], row_cells[win_row[w]].data() + win_pos[w], k);
+                    }
+                });
+            }
+
+            for (int w = 0; w < nw; ++w) {
+                st.gain += win_gain[w];
+                st.improved += win_gain[w] > 0;
+            }
+            st.windows += nw;
+            ++st.rounds;
+        }
+        if (st.gain == before) break;
+    }
+    PDA_PROF_COUNT("reorder.windows", st.windows);
+    PDA_PROF_COUNT("reorder.improved", st.improved);
+    PDA_PROF_SAMPLE("reorder.gain", st.gain);
+    return st;
+}
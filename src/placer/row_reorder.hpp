@@ -0,0 +1,83 @@
+#pragma once
+#include "../core/deadline.hpp"
+#include "../core/netlist.hpp"
+#include "../core/thread_pool.hpp"
+#include "row_index.hpp"
+#include "window_scheduler.hpp"
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// Row 內局部重排 (branch-and-bound)
+// ==========================================
+// 沿著每條 row 以 k 個連續可動單元為一個視窗 (每次右移一格)，
+// 在原本的範圍內嘗試所有排列：單元依實際寬度由左往右排，
+// 單元之間的空隙序列維持不變，所以結果一定落在 site 上且不重疊。
+// 部分排列的 HPWL (外部 pin 的 bounding box 加上已放好的單元) 只會增加，
+// 可以當下界剪枝。
+//
+// 各 row 的第 t 個視窗組成第 t 輪；同一輪內不共用 net 的視窗由
+// WindowScheduler 分到同一個 batch 平行處理，結果與執行緒數無關
+// (高扇出 net 不算衝突，成本以該輪開始時的 box 計算)。
+struct ReorderOptions {
+    int window = 4;   // 視窗內的單元數 (3 ~ 6)
+    int passes = 1;
+    int max_net_degree = 64;   // 更大的 net 不算視窗之間的衝突
+    core::Deadline deadline;   // 到期後不再開始新的一輪
+};
+
+class RowReorder {
+public:
+    struct Stats {
+        long long gain = 0;
+        int windows = 0;
+        int improved = 0;
+        int rounds = 0;
+    };
+
+    RowReorder(core::Netlist& nl, const RowIndex& index, core::ThreadPool& pool);
+
+    // 座標直接寫進 netlist；RowIndex 不會更新，之後需要時要重建
+    Stats run(const ReorderOptions& opt);
+
+private:
+    struct Box {
+        int xmin = numeric_limits<int>::max(), xmax = numeric_limits<int>::min();
+        int ymin = numeric_limits<int>::max(), ymax = numeric_limits<int>::min();
+        void add(int x, int y) {
+            xmin = min(xmin, x); xmax = max(xmax, x);
+            ymin = min(ymin, y); ymax = max(ymax, y);
+        }
+        long long hpwl() const { return xmin > xmax ? 0 : (long long)(xmax - xmin) + (ymax - ymin); }
+    };
+
+    // 每個執行緒一份
+    struct Workspace {
+        int k = 0, y = 0;
+        vector<int> cells, width, gap;       // 視窗內單元 (原順序)、寬度、slot 之後的空隙
+        vector<int> nets;                    // 視窗碰到的 net (局部編號 = 索引)
+        vector<Box> box;                     // 目前的 bounding box (一開始只有外部 pin)
+        vector<int> cell_net_start, cell_nets; // 單元 -> 局部 net (CSR)
+        vector<int> order, best_order;
+        vector<char> used;
+        vector<pair<int, Box>> saved;        // DFS 還原用
+        vector<int> mark;                    // 大小 num_insts，標記視窗內單元
+        int stamp = 0;
+        long long best = 0;
+    };
+
+    core::Netlist& netlist;
+    const RowIndex& index;
+    core::ThreadPool& pool;
+    vector<Workspace> workspaces;
+
+    vector<vector<int>> row_cells;   // 各 row 依 x 排序的單元 (含 FIXED)
+    vector<vector<int>> row_starts;  // 各 row 可用視窗的起點 (row_cells 索引)
+    WindowScheduler scheduler;
+
+    void collect(int k);
+    long long reorderWindow(Workspace& ws, int* cells, int k);
+    void dfs(Workspace& ws, int depth, int x, long long partial);
+};
@@ -0,0 +1,171 @@
+#include "row_shift.hpp"
+#include "../core/hpwl.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+static int floor_grid(int v, int x0, int step) {
+    int d = v - x0;
+    return x0 + (d >= 0 ? d / step : -((-d + step - 1) / step)) * step;
+}
+
+// 單元在 cluster 中 offset 處，各 net (去掉自己) 的 [lo, hi] 換算成 cluster 左緣的斷點
+void RowShift::cellBreakpoints(int inst, int offset, vector<int>& out) const {
+    bool any = false;
+    for (int k = netlist.instBegin(inst); k < netlist.instEnd(inst); ++k) {
+        int n = netlist.inst_nets[k];
+        int deg = netlist.netDegree(n);
+        if (deg < 2 || deg > max_net_degree) continue;
+        int lo = numeric_limits<int>::max(), hi = numeric_limits<int>::min();
+        for (int q = netlist.netBegin(n); q < netlist.netEnd(n); ++q) {
+            int node = netlist.net_pins[q];
+            if (node == inst) continue;
+            lo = min(lo, netlist.x[node]);
+            hi = max(hi, netlist.x[node]);
+        }
+        out.push_back(lo - offset);
+        out.push_back(hi - offset);
+        any = true;
+    }
+    // 沒有 net 牽制的單元希望留在原地
+    if (!any) {
+        out.push_back(netlist.x[inst] - offset);
+        out.push_back(netlist.x[inst] - offset);
+    }
+}
+
+// 斷點中位數區間內、離目前位置最近的格點；區間內沒有格點時比較兩側格點的成本
+int RowShift::bestX(Cluster& c, int lo, int hi, int x0, int step) {
+    auto& b = c.bps;
+    size_t h = b.size() / 2; // 斷點成對出現，個數為偶數
+    nth_element(b.begin(), b.begin() + (h - 1), b.end());
+    int m1 = b[h - 1];
+    int m2 = *min_element(b.begin() + h, b.end());
+
+    int cur = netlist.x[seg[c.first]];
+    int g1 = floor_grid(m2, x0, step);         // <= m2 的最大格點
+    int x;
+    if (g1 >= m1) {
+        x = min(max(cur, m1), m2);
+        x = floor_grid(x, x0, step);
+        if (x < m1) x += step;
+    } else {
+        int g2 = g1 + step;                    // > m2 的最小格點
+        long long c1 = 0, c2 = 0;
+        for (int v : b) { c1 += abs(g1 - v); c2 += abs(g2 - v); }
+        x = c1 <= c2 ? g1 : g2;
+    }
+    // 成本是凸的，超出 segment 時夾到邊界即為最佳 (hi 已對齊格點)
+    return max(lo, min(x, hi - c.width));
+}
+
+long long RowShift::shiftSegment(int lo, int hi, int x0, int step) {
+    const int m = (int)seg.size();
+    hi = floor_grid(hi, x0, step);
+    int total = 0;
+    for (int c : seg) total += netlist.width[c];
+    if (m == 0 || total > hi - lo) return 0;
+
+    clusters.clear();
+    for (int i = 0; i < m; ++i) {
+        Cluster c;
+        c.first = i;
+        c.width = netlist.width[seg[i]];
+        cellBreakpoints(seg[i], 0, c.bps);
+        c.x = bestX(c, lo, hi, x0, step);
+
+        // 與前一個 cluster 重疊就合併
+        while (!clusters.empty() && clusters.back().x + clusters.back().width > c.x) {
+            Cluster& p = clusters.back();
+            for (int v : c.bps) p.bps.push_back(v - p.width);
+            p.width += c.width;
+            c = std::move(p);
+            clusters.pop_back();
+            c.x = bestX(c, lo, hi, x0, step);
+        }
+        clusters.push_back(std::move(c));
+    }
+
+    new_x.resize(m);
+    bool changed = false;
+    for (size_t k = 0; k < clusters.size(); ++k) {
+        int end = k + 1 < clusters.size() ? clusters[k + 1].first : m;
+        int x = clusters[k].x;
+        for (int i = clusters[k].first; i < end; ++i) {
+            new_x[i] = x;
+            changed |= (x != netlist.x[seg[i]]);
+            x += netlist.width[seg[i]];
+        }
+    }
+    if (!changed) return 0;
+
+    // 以實際 HPWL 檢查 (同一 segment 內共用 net 的單元在模型裡被當成不動)
+    nets.clear();
+    for (int c : seg) {
+        nets.insert(nets.end(), netlist.inst_nets.begin() + netlist.instBegin(c),
+                    netlist.inst_nets.begin() + netlist.instEnd(c));
+    }
+    sort(nets.begin(), nets.end());
+    nets.erase(unique(nets.begin(), nets.end()), nets.end());
+
+    long long before = 0, after = 0;
+    for (int n : nets) before += core::net_hpwl(netlist, n);
+    for (int i = 0; i < m; ++i) swap(netlist.x[seg[i]], new_x[i]);
+    for (int n : nets) after += core::net_hpwl(netlist, n);
+    if (after < before) return before - after;
+
+    for (int i = 0; i < m; ++i) swap(netlist.x[seg[i]], new_x[i]);
+    return 0;
+}
+
+RowShift::Stats RowShift::run(const RowIndex& index) {
+    PDA_PROF_SCOPE("opt.shift");
+    Stats st;
+    for (int r = 0; r < index.numRows(); ++r) {
+        if (deadline.expired()) break;
+        const RowIndex::Row& row = index.row(r);
+        for (const RowIndex::Segment& sg : row.segs) {
+            int lo = sg.x0;
+            seg.clear();
+            auto flush = [&](int hi) {
+                if (!seg.empty()) {
+                    ++st.segments;
+                    long long g = shiftSegment(lo, hi, sg.x0, sg.step);
+                    if (g > 0) { st.gain += g; ++st.improved; }
+                }
+                seg.clear();
+            };
+
+            bool ok = true; // segment 內單元寬度都是 site 的整數倍且沒有重疊
+            int reach = lo;
+            // 從左邊 max_width 內開始的單元起算：跨進這段的單元也是障礙物
+            for (auto it = row.cells.lower_bound({sg.x0 - row.max_width + 1, -1});
+                 it != row.cells.end() && it->first < sg.x1; ++it) {
+                const auto [x, inst] = *it;
+                int w = netlist.width[inst];
+                bool movable = !netlist.fixed[inst] && netlist.y[inst] == row.y && netlist.height[inst] <= row.height &&
+                               x >= sg.x0 && x + w <= sg.x1;
+                if (!movable) {
+                    if (ok) flush(min(x, sg.x1));
+                    seg.clear();
+                    ok = true;
+                    // 障礙物右緣之後的第一個格點
+                    lo = max(lo, x + w);
+                    int g = floor_grid(lo, sg.x0, sg.step);
+                    lo = g < lo ? g + sg.step : g;
+                    reach = lo;
+                    continue;
+                }
+                if (x < reach || w % sg.step != 0) ok = false;
+                reach = max(reach, x + w);
+                seg.push_back(inst);
+            }
+            if (ok) flush(sg.x1);
+        }
+    }
+    PDA_PROF_COUNT("shift.segments", st.segments);
+    PDA_PROF_COUNT("shift.improved", st.improved);
+    PDA_PROF_SAMPLE("shift.gain", st.gain);
+    return st;
+}
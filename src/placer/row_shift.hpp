@@ -0,0 +1,55 @@
+#pragma once
+#include "../core/deadline.hpp"
+#include "../core/netlist.hpp"
+#include "row_index.hpp"
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// Row segment 內的單元平移 (clumping)
+// ==========================================
+// 固定單元的順序，只調整 x。segment 是 row 上兩個障礙物 (FIXED / 多 row macro /
+// ROW segment 邊界) 之間的可動單元，格點用所在 ROW segment 的原點與 site 寬度。
+// 把同一 net 上其他 pin 視為不動，單元在 x 的成本是
+//   sum_n max(0, lo_n - x) + max(0, x - hi_n) = 1/2 sum_n (|x - lo_n| + |x - hi_n|) + 常數
+// 也就是斷點 {lo_n, hi_n} 的絕對值和，最佳位置是斷點的中位數。
+// 由左往右把單元放到各自的最佳位置，與前一個 cluster 重疊就合併 (cluster 的
+// 最佳位置仍是所有斷點扣掉 offset 後的中位數)，一路合併到不重疊為止。
+// 位置都對齊 site，結果用受影響 net 的實際 HPWL 確認變好才保留。
+class RowShift {
+public:
+    struct Stats {
+        long long gain = 0;
+        int segments = 0;
+        int improved = 0;
+    };
+
+    int max_net_degree = 64; // 更大的 net 不產生斷點 (仍計入實際 HPWL 的檢查)
+    core::Deadline deadline; // 到期後不再處理剩下的 row
+
+    explicit RowShift(core::Netlist& nl) : netlist(nl) {}
+
+    // 座標直接寫進 netlist；RowIndex 不會更新
+    Stats run(const RowIndex& index);
+
+private:
+    struct Cluster {
+        int first = 0;          // segment 內第一個單元的索引
+        int width = 0;
+        int x = 0;
+        vector<int> bps;        // 以 cluster 左緣表示的斷點
+    };
+
+    core::Netlist& netlist;
+
+    // 暫存
+    vector<int> seg;            // segment 內的單元
+    vector<int> new_x;
+    vector<Cluster> clusters;
+    vector<int> nets;
+
+    void cellBreakpoints(int inst, int offset, vector<int>& out) const;
+    int bestX(Cluster& c, int lo, int hi, int x0, int step);
+    long long shiftSegment(int lo, int hi, int x0, int step);
+};
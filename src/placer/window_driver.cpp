@@ -0,0 +1,230 @@
+#include "window_driver.hpp"
+#include "../core/hpwl.hpp"
+#include "../core/hpwl_parallel.hpp"
+#include "../core/profiler.hpp"
+#include <algorithm>
+#include <iostream>
+
+WindowDriver::WindowDriver(core::Design& d, core::Netlist& nl, DetailedPlacer& dp, core::ThreadPool& pool)
+    : design(d), netlist(nl), pool(pool), shifter(nl) {
+    for (const auto& r : design.rows) row_y.push_back(r.y0);
+    sort(row_y.begin(), row_y.end());
+    row_y.erase(unique(row_y.begin(), row_y.end()), row_y.end());
+
+    if (!design.rows.empty()) {
+        grid_x0 = design.rows[0].x0;
+        step_x = max(1, design.rows[0].step_x);
+        for (const auto& r : design.rows) grid_x0 = min(grid_x0, r.x0);
+    }
+
+    workspaces.reserve(pool.size());
+    for (int t = 0; t < pool.size(); ++t) workspaces.emplace_back(dp);
+}
+
+int WindowDriver::rowOf(int y) const {
+    auto it = lower_bound(row_y.begin(), row_y.end(), y);
+    if (it == row_y.end() || *it != y) return -1;
+    return int(it - row_y.begin());
+}
+
+static int floor_div(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+WindowDriver::PassStats WindowDriver::runPass(const WindowOptions& opt, int row_off, int col_off) {
+    PDA_PROF_SCOPE("opt.window_pass");
+    PassStats st;
+    const int W = max(1, opt.window_sites), R = max(1, opt.window_rows);
+    const int total_cols = design.rows.empty() ? 1 : (design.die_urx - grid_x0) / step_x + 1;
+    const int win_cols = floor_div(total_cols + col_off, W) + 2;
+
+    // 1. 把可動單元分桶到視窗
+    vector<pair<long long, int>> keyed;
+    keyed.reserve(netlist.num_insts);
+    for (int i = 0; i < netlist.num_insts; ++i) {
+        if (netlist.fixed[i] || netlist.width[i] <= 0) continue;
+        int r = rowOf(netlist.y[i]);
+        if (r < 0) continue;
+        int col = (netlist.x[i] - grid_x0) / step_x;
+        long long wr = floor_div(r + row_off, R) + 1;
+        long long wc = floor_div(col + col_off, W) + 1;
+        keyed.push_back({wr * win_cols + wc, i});
+    }
+    sort(keyed.begin(), keyed.end());
+
+    // 2. 視窗內依 (寬度, 高度, ID) 排序，只留下至少兩個單元的同尺寸群組
+    //    (分桶只看左下角的 row，高度不同的單元互換位置會蓋到別的 row)
+    win_start.assign(1, 0);
+    win_group.assign(1, 0);
+    group_start.assign(1, 0);
+    win_cells.clear();
+    vector<int> cells;
+    for (size_t b = 0; b < keyed.size(); ) {
+        size_t e = b;
+        cells.clear();
+        while (e < keyed.size() && keyed[e].first == keyed[b].first) cells.push_back(keyed[e++].second);
+        b = e;
+
+        sort(cells.begin(), cells.end(), [&](int a, int c) {
+            if (netlist.width[a] != netlist.width[c]) return netlist.width[a] < netlist.width[c];
+            if (netlist.height[a] != netlist.height[c]) return netlist.height[a] < netlist.height[c];
+            return a < c;
+        });
+        auto same_size = [&](int a, int c) {
+            return netlist.width[a] == netlist.width[c] && netlist.height[a] == netlist.height[c];
+        };
+        for (size_t g = 0; g < cells.size(); ) {
+            size_t h = g;
+            while (h < cells.size() && same_size(cells[h], cells[g])) ++h;
+            // 太大的群組切成幾段分別求解 (指派是 O(k^3))，每段仍是同尺寸
+            const size_t cap = opt.max_group >= 2 ? opt.max_group : h - g;
+            for (size_t s = g; s + 2 <= h; s += cap) {
+                size_t t = min(h, s + cap);
+                win_cells.insert(win_cells.end(), cells.begin() + s, cells.begin() + t);
+                group_start.push_back((int)win_cells.size());
+            }
+            g = h;
+        }
+        if ((int)win_cells.size() == win_start.back()) continue; // 沒有可解的群組
+        win_start.push_back((int)win_cells.size());
+        win_group.push_back((int)group_start.size() - 1);
+    }
+    const int num_windows = (int)win_start.size() - 1;
+
+    // 3. 衝突圖著色後逐 batch 平行處理；每個視窗的結果寫在自己的位置，
+    //    最後依視窗編號加總，統計值也與執行緒數無關
+    scheduler.max_net_degree = opt.max_net_degree;
+    scheduler.build(netlist, win_start, win_cells);
+    st.batches = scheduler.numBatches();
+    for (auto& ws : workspaces) ws.placer.frozen = &scheduler.frozen();
+
+    vector<long long> win_gain(num_windows, 0);
+    vector<int> win_improved(num_windows, 0);
+    const vector<int>& order = scheduler.order();
+    for (int bt = 0; bt < scheduler.numBatches(); ++bt) {
+        const int base = scheduler.batchBegin(bt);
+        pool.parallel_for(scheduler.batchSize(bt), 1, [&](int b, int e, int tid) {
+            Workspace& ws = workspaces[tid];
+            for (int q = b; q < e; ++q) {
+                if (opt.deadline.expired()) break;
+                int w = order[base + q];
+                for (int g = win_group[w]; g < win_group[w + 1]; ++g) {
+                    long long gain = solveGroup(ws, win_cells.data() + group_start[g],
+                                                group_start[g + 1] - group_start[g], opt.warm_start);
+                    if (gain > 0) {
+                        win_gain[w] += gain;
+                        ++win_improved[w];
+                    }
+                }
+            }
+        });
+    }
+
+    for (int w = 0; w < num_windows; ++w) {
+        st.gain += win_gain[w];
+        st.improved += win_improved[w];
+        st.windows += win_group[w + 1] - win_group[w];
+    }
+    PDA_PROF_COUNT("window.groups", st.windows);
+    PDA_PROF_COUNT("window.improved", st.improved);
+    PDA_PROF_COUNT("window.batches", st.batches);
+    PDA_PROF_SAMPLE("window.pass_gain", st.gain);
+    return st;
+}
+
+long long WindowDriver::solveGroup(Workspace& ws, const int* cells, int count, bool warm) {
+    ws.modules.assign(cells, cells + count);
+    ws.slots.clear();
+    for (int c : ws.modules) ws.slots.push_back({netlist.x[c], netlist.y[c]});
+
+    // slot i 就是 module i 目前的位置，也就是前一個 pass 重疊視窗留下的結果
+    const int* init = nullptr;
+    if (warm) {
+        for (int i = (int)ws.identity.size(); i < count; ++i) ws.identity.push_back(i);
+        init = ws.identity.data();
+    }
+    if (!ws.placer.assignRegion(ws.modules, ws.slots, ws.assignment, init)) return -1;
+
+    ws.moved.clear();
+    for (int i = 0; i < count; ++i) {
+        int j = ws.assignment[i];
+        if (j < 0) return -1;
+        if (j != i) ws.moved.push_back(i);
+    }
+    if (ws.moved.empty()) return -1;
+
+    // 指派成本是近似值 (群組內其他單元視為不動)，以受影響 net 的實際 HPWL 決定是否保留；
+    // 固定的 net 不讀其他單元的座標，以 pass 開始時的 box 加上移動後的位置計算
+    ws.nets.clear();
+    for (int i : ws.moved) {
+        int inst = ws.modules[i];
+        ws.nets.insert(ws.nets.end(), netlist.inst_nets.begin() + netlist.instBegin(inst),
+                       netlist.inst_nets.begin() + netlist.instEnd(inst));
+    }
+    sort(ws.nets.begin(), ws.nets.end());
+    ws.nets.erase(unique(ws.nets.begin(), ws.nets.end()), ws.nets.end());
+
+    const FrozenNets& frozen = scheduler.frozen();
+    ws.frozen_nets.clear();
+    ws.frozen_box.clear();
+    for (int n : ws.nets) {
+        if (!frozen.frozen(netlist, n)) continue;
+        ws.frozen_nets.push_back(n);
+        ws.frozen_box.push_back(frozen.box[n]);
+    }
+    long long before = 0, after = 0;
+    for (int n : ws.nets) {
+        if (!frozen.frozen(netlist, n)) before += core::net_hpwl(netlist, n);
+    }
+    for (const auto& b : ws.frozen_box) before += b.hpwl();
+    for (int i : ws.moved) {
+        const int inst = ws.modules[i];
+        const auto& p = ws.slots[ws.assignment[i]];
+        netlist.x[inst] = p.x;
+        netlist.y[inst] = p.y;
+        for (int q = netlist.instBegin(inst); q < netlist.instEnd(inst); ++q) {
+            const int n = netlist.inst_nets[q];
+            if (!frozen.frozen(netlist, n)) continue;
+            auto it = lower_bound(ws.frozen_nets.begin(), ws.frozen_nets.end(), n);
+            ws.frozen_box[it - ws.frozen_nets.begin()].add(p.x, p.y);
+        }
+    }
+    for (int n : ws.nets) {
+        if (!frozen.frozen(netlist, n)) after += core::net_hpwl(netlist, n);
+    }
+    for (const auto& b : ws.frozen_box) after += b.hpwl();
+
+    if (after < before) return before - after;
+
+    // 沒變好：還原 (slots 就是原本的位置)
+    for (int i : ws.moved) {
+        netlist.x[ws.modules[i]] = ws.slots[i].x;
+        netlist.y[ws.modules[i]] = ws.slots[i].y;
+    }
+    return -1;
+}
+
+long long WindowDriver::run(const WindowOptions& opt) {
+    long long hpwl = core::hpwl_counts_parallel(netlist, pool);
+    for (int p = 0; p < opt.passes && !opt.deadline.expired(); ++p) {
+        // 奇數 pass 偏移半個視窗，讓視窗邊界上的單元也能被一起最佳化
+        int row_off = (p % 2) ? opt.window_rows / 2 : 0;
+        int col_off = (p % 2) ? opt.window_sites / 2 : 0;
+        PassStats st = runPass(opt, row_off, col_off);
+        if (opt.shift) {
+            // 交換留下的空隙用平移補回來
+            index.build(design, netlist);
+            shifter.deadline = opt.deadline;
+            st.shift_gain = shifter.run(index).gain;
+            st.gain += st.shift_gain;
+        }
+
+        long long before = hpwl;
+        hpwl = core::hpwl_counts_parallel(netlist, pool);
+        if (opt.verbose) {
+            cout << "pass " << p + 1 << " hpwl " << hpwl << " gain " << st.gain
+                 << " (" << st.improved << "/" << st.windows << " groups, "
+                 << st.batches << " batches, shift " << st.shift_gain << ")\n";
+        }
+        if (before == 0 || (double)st.gain / before < opt.tolerance) break;
+    }
+    return hpwl;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "../core/design.hpp"
+#include "../core/deadline.hpp"
+#include "../core/netlist.hpp"
+#include "../core/thread_pool.hpp"
+#include "detailed_placer.hpp"
+#include "row_index.hpp"
+#include "row_shift.hpp"
+#include "window_scheduler.hpp"
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 全晶片視窗掃描 (window sweeping)
+// ==========================================
+// 把 row 切成 window_rows x window_sites 的視窗，每個視窗內把可動單元依 (寬度, 高度) 分組，
+// 同尺寸的單元互換位置一定合法，交給 DetailedPlacer::assignRegion 求最佳指派。
+// 指派的成本把視窗內其他單元當成不動，所以結果再以實際 HPWL 精算，
+// 只有真的變好才保留。每個 pass 的視窗偏移半個視窗，直到改善低於門檻。
+//
+// 視窗經 WindowScheduler 分成互不共用 net 的 batch，batch 內的視窗平行處理，
+// 每個執行緒有自己的 DetailedPlacer (成本矩陣 / LAP / MCMF 暫存)。
+// degree 超過 max_net_degree 的 net 不算衝突，成本與精算都改用 pass 開始時的 box
+// (FrozenNets)，否則一條 reset net 就讓所有視窗排成一列。結果與執行緒數無關。
+struct WindowOptions {
+    int window_sites = 96;     // 視窗寬度 (site 數)
+    int window_rows = 4;       // 視窗高度 (row 數)
+    int passes = 6;            // 最多幾個 pass
+    double tolerance = 1e-4;   // 一個 pass 的改善比例低於此值就停止
+    int max_group = 0;         // 同尺寸群組最多幾個單元，超過就切段；0 為不限制
+    bool shift = true;         // 每個 pass 之後做 row segment 平移 (RowShift)
+    bool warm_start = true;    // 以目前的排列 (上一個重疊視窗的結果) 當 LAP 的初始指派
+    int max_net_degree = 64;   // 更大的 net 不算視窗之間的衝突；0 為所有 net 都算
+    bool verbose = true;       // 每個 pass 印出 HPWL
+    core::Deadline deadline;   // 到期後不再開始新的視窗 (已解的結果保留)
+};
+
+class WindowDriver {
+public:
+    struct PassStats {
+        long long gain = 0;    // HPWL 減少量
+        int windows = 0;       // 解過的指派問題數
+        int improved = 0;      // 被保留的數量
+        int batches = 0;       // 衝突圖著色後的 batch 數
+        long long shift_gain = 0; // pass 之後 RowShift 的改善量
+    };
+
+    WindowDriver(core::Design& d, core::Netlist& nl, DetailedPlacer& dp, core::ThreadPool& pool);
+
+    // 執行多個 pass，回傳最終 HPWL
+    long long run(const WindowOptions& opt);
+
+    // 以 (row_off, col_off) 的偏移跑一個 pass
+    PassStats runPass(const WindowOptions& opt, int row_off, int col_off);
+
+    // y 座標對應的 row 索引 (依 y 排序)，不在任何 row 上回傳 -1
+    int rowOf(int y) const;
+
+private:
+    core::Design& design;
+    core::Netlist& netlist;
+    core::ThreadPool& pool;
+
+    vector<int> row_y;         // 排序後各 row 的 y
+    int grid_x0 = 0, step_x = 1;
+
+    // 每個執行緒一份的暫存
+    struct Workspace {
+        DetailedPlacer placer;
+        vector<int> modules;
+        vector<DetailedPlacer::Pos> slots;
+        vector<int> assignment;
+        vector<int> identity;  // warm start 的初始指派：module i 在 slot i
+        vector<int> moved;     // 位置有變的 module 索引
+        vector<int> nets;      // 受影響的 net
+        vector<int> frozen_nets;            // nets 中固定的 net (遞增)
+        vector<FrozenNets::Box> frozen_box; // 對應的 box，加上移動後的位置
+        explicit Workspace(const DetailedPlacer& dp) : placer(dp) {}
+    };
+    vector<Workspace> workspaces;
+
+    // 一個 pass 的視窗：視窗 -> 群組 -> 單元，皆為 CSR
+    vector<int> win_start;     // 視窗 -> win_cells (也是著色的輸入)
+    vector<int> win_group;     // 視窗 -> groups 的起點，大小 num_windows + 1
+    vector<int> group_start;   // 群組 -> win_cells
+    vector<int> win_cells;
+    WindowScheduler scheduler;
+
+    RowIndex index;            // RowShift 用，每次平移前重建
+    RowShift shifter;
+
+    // 解一組同尺寸單元，回傳保留下來的 HPWL 改善量 (沒改善為 -1)
+    long long solveGroup(Workspace& ws, const int* cells, int count, bool warm);
+};
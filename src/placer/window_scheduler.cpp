@@ -0,0 +1,82 @@
+#include "window_scheduler.hpp"
+#include <algorithm>
+
+void WindowScheduler::build(const core::Netlist& nl, const vector<int>& win_start, const vector<int>& win_cells) {
+    const int num_windows = (int)win_start.size() - 1;
+    color.assign(max(0, num_windows), 0);
+
+    // 只清掉上一次碰過的 net，視窗很少時 (例如 row 重排的每一輪) 不必 O(num_nets)
+    if ((int)net_colors.size() != nl.num_nets) {
+        net_colors.assign(nl.num_nets, {});
+        net_seen.assign(nl.num_nets, -1);
+        frozen_nets.box.assign(nl.num_nets, FrozenNets::Box{});
+        touched.clear();
+    }
+    for (int n : touched) {
+        net_colors[n].clear();
+        net_seen[n] = -1;
+    }
+    touched.clear();
+    frozen_nets.max_degree = max_net_degree;
+
+    // color_mark[c] == w 表示視窗 w 不能用顏色 c；只在顏色變多時加長，不必每個視窗重設
+    color_mark.assign(1, -1);
+    int num_colors = 0;
+    for (int w = 0; w < num_windows; ++w) {
+        // 1. 標記鄰居 (共用 net 的較早視窗) 用過的顏色；固定的 net 第一次碰到時記下 box
+        for (int k = win_start[w]; k < win_start[w + 1]; ++k) {
+            int inst = win_cells[k];
+            for (int q = nl.instBegin(inst); q < nl.instEnd(inst); ++q) {
+                int n = nl.inst_nets[q];
+                if (net_seen[n] == w) continue;
+                const bool first = net_seen[n] < 0;
+                if (first) touched.push_back(n);
+                net_seen[n] = w;
+                if (frozen_nets.frozen(nl, n)) {
+                    if (first) {
+                        FrozenNets::Box& b = frozen_nets.box[n];
+                        b = FrozenNets::Box{};
+                        for (int p = nl.netBegin(n); p < nl.netEnd(n); ++p) b.add(nl.x[nl.net_pins[p]], nl.y[nl.net_pins[p]]);
+                    }
+                    continue;
+                }
+                for (int c : net_colors[n]) color_mark[c] = w;
+            }
+        }
+
+        // 2. 取最小的可用顏色
+        int c = 0;
+        while (color_mark[c] == w) ++c;
+        color[w] = c;
+        if (c == num_colors) {
+            ++num_colors;
+            color_mark.push_back(-1);
+        }
+
+        // 3. 把顏色登記到這個視窗碰到的 net 上 (net_seen 仍是 w)
+        for (int k = win_start[w]; k < win_start[w + 1]; ++k) {
+            int inst = win_cells[k];
+            for (int q = nl.instBegin(inst); q < nl.instEnd(inst); ++q) {
+                const int n = nl.inst_nets[q];
+                if (frozen_nets.frozen(nl, n)) continue;
+                auto& nc = net_colors[n];
+                if (nc.empty() || nc.back() != c) nc.push_back(c);
+            }
+        }
+    }
+
+    // counting sort: 視窗依顏色分組
+    batch_start.assign(num_colors + 1, 0);
+    for (int w = 0; w < num_windows; ++w) ++batch_start[color[w] + 1];
+    for (int c = 0; c < num_colors; ++c) batch_start[c + 1] += batch_start[c];
+    batch_windows.assign(max(0, num_windows), 0);
+    vector<int> fill(batch_start.begin(), batch_start.end() - 1);
+    for (int w = 0; w < num_windows; ++w) batch_windows[fill[color[w]]++] = w;
+
+    for (int c = 0; c < num_colors; ++c) {
+        stable_sort(batch_windows.begin() + batch_start[c], batch_windows.begin() + batch_start[c + 1],
+                    [&](int a, int b) {
+                        return win_start[a + 1] - win_start[a] > win_start[b + 1] - win_start[b];
+                    });
+    }
+}
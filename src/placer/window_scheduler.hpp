@@ -0,0 +1,50 @@
+#pragma once
+#include "../core/netlist.hpp"
+#include "frozen_nets.hpp"
+#include <vector>
+
+using namespace std;
+
+// ==========================================
+// 視窗衝突圖與批次排程
+// ==========================================
+// 兩個視窗若有可動單元連到同一條 net，其中一個搬動單元會改變另一個的成本，
+// 兩者之間就有一條衝突邊。衝突圖不展開成鄰接表 (高扇出 net 會變成 O(w^2) 條邊)，
+// 而是透過 net -> 視窗的關聯做 greedy 著色：依視窗編號順序，
+// 每個視窗取「同 net 上其他視窗都沒用過的最小顏色」。
+// 同一個顏色 (batch) 內的視窗兩兩不共用 net，可以任意順序 / 同時處理，
+// 結果與依 (batch, 視窗編號) 順序的序列執行完全相同。
+// degree 超過 max_net_degree 的 net 不算衝突，改記下 build 當下的 box (FrozenNets)，
+// 視窗的成本對這些 net 只能用 frozen() 的 box。
+class WindowScheduler {
+public:
+    int max_net_degree = 64;   // 與 GlobalSwap / RowShift 相同；0 為所有 net 都算衝突
+
+    // 視窗以 CSR 給定：視窗 w 的單元為 win_cells[win_start[w] .. win_start[w+1])
+    void build(const core::Netlist& nl, const vector<int>& win_start, const vector<int>& win_cells);
+
+    int numBatches() const { return (int)batch_start.size() - 1; }
+    int batchBegin(int b) const { return batch_start[b]; }
+    int batchEnd(int b) const { return batch_start[b + 1]; }
+    int batchSize(int b) const { return batch_start[b + 1] - batch_start[b]; }
+
+    // batch 內依工作量 (單元數) 由大到小排列，讓動態分配時大視窗先開始
+    const vector<int>& order() const { return batch_windows; }
+
+    const vector<int>& colors() const { return color; }
+
+    // 上一次 build 的固定 net 與其 box
+    const FrozenNets& frozen() const { return frozen_nets; }
+
+private:
+    vector<int> color;           // 視窗 -> batch
+    vector<int> batch_start;     // CSR: batch -> 視窗
+    vector<int> batch_windows;
+    FrozenNets frozen_nets;
+
+    // 著色用暫存 (跨 build 重複使用)
+    vector<vector<int>> net_colors; // net 上已出現的顏色
+    vector<int> net_seen;           // 避免同一視窗重複處理同一條 net
+    vector<int> color_mark;
+    vector<int> touched;            // 這次 build 碰過的 net
+};